@@ -0,0 +1,256 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Measures the cost of drawing, and writes the results to stdout as JSON, so
+// that runs can be compared to catch regressions:
+//
+//   benchmark [--runs N] [path/to/vramsteg ...]
+//
+// For every style and width, it reports the time per Progress::update, the
+// time per frame when every frame is a full repaint, and the bytes emitted per
+// frame in both cases.  For each binary given, it also reports the wall time of
+// a complete 'vramsteg --current N' invocation, as the scripts in examples/
+// make, drawing on a pseudo-terminal, so that builds can be compared.  It also
+// reports how fast --lines counts newlines.
+
+#include <cmake.h>
+#include <Progress.h>
+#include <main.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+static const long updates  = 200000;
+static const long repaints = 20000;
+
+////////////////////////////////////////////////////////////////////////////////
+static double nanoseconds (std::chrono::steady_clock::time_point since, long count)
+{
+  auto span = std::chrono::steady_clock::now () - since;
+  return std::chrono::duration <double, std::nano> (span).count () / count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void prepare (Progress& progress, const std::string& style, int width)
+{
+  progress.style      = style;
+  progress.width      = width;
+  progress.label      = "label";
+  progress.minimum    = 0;
+  progress.maximum    = updates;
+  progress.percentage = true;
+  progress.elapsed    = true;
+  progress.estimate   = true;
+  progress.start      = time (nullptr) - 30;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Counts every value from minimum to maximum, as stream mode would, so most
+// updates change nothing visible, and the rest only change a few cells.
+static void benchmarkRender (const std::string& style, int width, bool first)
+{
+  Progress incremental;
+  prepare (incremental, style, width);
+
+  long frames = 0;
+  size_t bytes = 0;
+  auto started = std::chrono::steady_clock::now ();
+  for (long value = 0; value <= updates; ++value)
+  {
+    if (incremental.refresh (value))
+    {
+      ++frames;
+      bytes += incremental.frame ().size ();
+    }
+  }
+  auto perUpdate = nanoseconds (started, updates + 1);
+
+  // Invalidating first forces every frame to be composed and emitted in full.
+  Progress full;
+  prepare (full, style, width);
+
+  size_t repainted = 0;
+  started = std::chrono::steady_clock::now ();
+  for (long i = 0; i < repaints; ++i)
+  {
+    full.invalidate ();
+    full.refresh (i * (updates / repaints));
+    repainted += full.frame ().size ();
+  }
+  auto perRepaint = nanoseconds (started, repaints);
+
+  printf ("%s    {\"style\": \"%s\", \"width\": %d, \"updates\": %ld, \"frames\": %ld, "
+          "\"ns_per_update\": %.1f, \"bytes_per_frame\": %.1f, "
+          "\"ns_per_repaint\": %.1f, \"bytes_per_repaint\": %.1f}",
+          (first ? "" : ",\n"),
+          (style == "" ? "default" : style.c_str ()),
+          width,
+          updates + 1,
+          frames,
+          perUpdate,
+          frames ? (double) bytes / frames : 0.0,
+          perRepaint,
+          (double) repainted / repaints);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Counts the lines in a buffer of text with lines of varying length, which is
+// held in the cache no more than a pipe buffer would be.
+static void benchmarkLines ()
+{
+  std::string text;
+  while (text.size () < (64 << 20))
+    text += std::string (20 + text.size () % 61, 'x') + "\n";
+
+  size_t lines = 0;
+  const int passes = 8;
+  auto started = std::chrono::steady_clock::now ();
+  for (int pass = 0; pass < passes; ++pass)
+    lines += countLines (text.data (), text.size ());
+  auto perByte = nanoseconds (started, (long) text.size () * passes);
+
+  printf (",\n  \"lines\": {\"bytes\": %zu, \"lines\": %zu, \"gb_per_second\": %.2f}",
+          text.size (),
+          lines / passes,
+          1.0 / perByte);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Runs the binary repeatedly with its output on a pseudo-terminal, so that it
+// draws, and drains the terminal between runs.
+static void benchmarkExec (const char* binary, int runs, bool first)
+{
+  auto master = posix_openpt (O_RDWR | O_NOCTTY);
+  if (master == -1 || grantpt (master) || unlockpt (master))
+  {
+    fprintf (stderr, "Error: Could not allocate a pseudo-terminal.\n");
+    exit (1);
+  }
+
+  auto slave = open (ptsname (master), O_RDWR | O_NOCTTY);
+  fcntl (master, F_SETFL, O_NONBLOCK);
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init (&actions);
+  posix_spawn_file_actions_adddup2 (&actions, slave, STDOUT_FILENO);
+  posix_spawn_file_actions_adddup2 (&actions, slave, STDERR_FILENO);
+
+  auto start = std::to_string (time (nullptr) - 30);
+  std::vector <double> times;
+  char buffer[4096];
+  for (int run = 0; run < runs; ++run)
+  {
+    auto current = std::to_string (run % 101);
+    const char* argv[] = {binary, "--width", "80", "--label", "label",
+                          "--min", "0", "--max", "100", "--current", current.c_str (),
+                          "--start", start.c_str (), "--percentage", "--elapsed",
+                          "--estimate", nullptr};
+
+    pid_t pid;
+    int status;
+    auto started = std::chrono::steady_clock::now ();
+    if (posix_spawn (&pid, binary, &actions, nullptr, const_cast <char**> (argv), environ) ||
+        waitpid (pid, &status, 0) == -1)
+    {
+      fprintf (stderr, "Error: Could not run %s.\n", binary);
+      exit (1);
+    }
+    times.push_back (nanoseconds (started, 1) / 1000.0);
+
+    while (read (master, buffer, sizeof (buffer)) > 0)
+      ;
+  }
+
+  posix_spawn_file_actions_destroy (&actions);
+  close (slave);
+  close (master);
+
+  double total = 0.0;
+  for (auto t : times)
+    total += t;
+
+  std::sort (times.begin (), times.end ());
+  printf ("%s    {\"binary\": \"%s\", \"command\": \"vramsteg --current N\", \"runs\": %d, "
+          "\"us_mean\": %.1f, \"us_min\": %.1f, \"us_median\": %.1f, \"us_p90\": %.1f}",
+          (first ? "" : ",\n"),
+          binary,
+          runs,
+          total / runs,
+          times.front (),
+          times[runs / 2],
+          times[runs * 9 / 10]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int argc, char** argv)
+{
+  int runs = 200;
+  std::vector <const char*> binaries;
+  for (int i = 1; i < argc; ++i)
+  {
+    if (! strcmp (argv[i], "--runs") && i + 1 < argc)
+      runs = std::max (1, atoi (argv[++i]));
+    else
+      binaries.push_back (argv[i]);
+  }
+
+  printf ("{\n  \"version\": \"%s\",\n  \"render\": [\n", VERSION);
+
+  bool first = true;
+  for (auto& style : {"", "mono", "text"})
+  {
+    for (auto width : {40, 80, 200})
+    {
+      benchmarkRender (style, width, first);
+      first = false;
+    }
+  }
+
+  printf ("\n  ]");
+  benchmarkLines ();
+
+  if (binaries.size ())
+  {
+    printf (",\n  \"exec\": [\n");
+    for (size_t i = 0; i < binaries.size (); ++i)
+      benchmarkExec (binaries[i], runs, i == 0);
+
+    printf ("\n  ]");
+  }
+
+  printf ("\n}\n");
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,470 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Board.h>
+#include <algorithm>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// New bars are configured like the prototype.
+Board::Board (const Progress& prototype)
+: _prototype (prototype)
+{
+  _tty = isatty (_prototype.fd);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A bar with an empty name uses the prototype label.  The output is held until
+// the next write, so that a batch of updates is emitted together.
+void Board::update (const std::string& name, long value)
+{
+  auto index = find (name);
+  if (index == -1)
+    index = add (name, value, false);
+
+  auto& bar = _bars[index];
+  bar.value = value;
+  bar.finished = false;
+  if (_prototype.steps)
+    bar.progress->measure ();
+
+  if (_tty && bar.progress->refresh (value))
+    draw (index);
+
+  if (_prototype.events != -1)
+    bar.progress->report (value, false);
+
+  if (_prototype.trace)
+    bar.progress->record (value, false);
+
+  if (_prototype.metrics)
+    bar.progress->publish (value, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A finished bar is drawn in its final state, and if bars are to be removed,
+// the bars below it move up to take its place.  The output is held until the
+// next write.
+void Board::finish (const std::string& name)
+{
+  auto index = find (name);
+  if (index == -1)
+    return;
+
+  _bars[index].finished = true;
+  if (_prototype.events != -1 && ! _bars[index].status)
+    _bars[index].progress->report (_bars[index].value, true);
+
+  if (_prototype.trace && ! _bars[index].status)
+    _bars[index].progress->record (_bars[index].value, true);
+
+  if (_prototype.metrics && ! _bars[index].status)
+    _bars[index].progress->publish (_bars[index].value, true);
+
+  if (! _prototype.remove && ! _bars[index].status)
+  {
+    if (_tty && _bars[index].progress->flush ())
+      draw (index);
+  }
+  else
+  {
+    _bars.erase (_bars.begin () + index);
+    for (int i = index; i < (int) _bars.size (); ++i)
+      _bars[i].progress->invalidate ();
+
+    relabel ();
+
+    if (_tty)
+    {
+      for (int i = index; i < (int) _bars.size (); ++i)
+        if (_bars[i].status || _bars[i].progress->refresh (_bars[i].value))
+          draw (i);
+
+      move (_bars.size ());
+      _output += "\033[2K";
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A status line shows text instead of a bar, such as what a worker is doing.
+// It is drawn below the bars added before it, and removed when finished,
+// whether or not bars are removed.  The output is held until the next write.
+void Board::status (const std::string& name, const std::string& text)
+{
+  auto index = find (name);
+  if (index == -1)
+    index = add (name, 0, true);
+
+  auto& bar = _bars[index];
+  bar.finished = false;
+  if (bar.text != text)
+  {
+    bar.text = text;
+    if (_tty)
+      draw (index);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writes text, such as the output of a command, above the block, which moves
+// down to make room, and is drawn again in full.  Without a terminal, the text
+// is simply written.  Text is never dropped, however slow the terminal.
+void Board::print (const std::string& text)
+{
+  if (text.empty ())
+    return;
+
+  if (_tty)
+  {
+    move (0);
+    _output += "\r\033[J";
+  }
+
+  _output += text;
+  if (text.back () != '\n')
+    _output += '\n';
+
+  if (_tty)
+  {
+    _line = 0;
+    _created = 1;
+    _lines = _bars.size ();
+    _stale = false;
+    for (int i = 0; i < (int) _bars.size (); ++i)
+    {
+      if (! _bars[i].status)
+      {
+        _bars[i].progress->dropped ();
+        _bars[i].progress->flush ();
+      }
+
+      draw (i);
+    }
+  }
+
+  _out.finish (_prototype.fd, _output.data (), _output.length ());
+  _output.clear ();
+  _shownLine = _line;
+  _shownCreated = _created;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Redraws the bars whose times have changed since they were drawn, or whose
+// frames were held back by throttling, without a new value.
+void Board::tick ()
+{
+  if (! _tty)
+    return;
+
+  if (_stale)
+    repaint ();
+
+  for (int i = 0; i < (int) _bars.size (); ++i)
+    if (! _bars[i].status && _bars[i].progress->refresh (_bars[i].value))
+      draw (i);
+
+  write ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Redraws every bar in full at a new width, clearing whatever the terminal
+// left of each line.
+void Board::resize (int width)
+{
+  if (width == _prototype.width)
+    return;
+
+  _prototype.width = width;
+  for (int i = 0; i < (int) _bars.size (); ++i)
+  {
+    auto& progress = *_bars[i].progress;
+    progress.width = width;
+    progress.invalidate ();
+    if (_tty)
+    {
+      move (i);
+      _output += "\033[2K";
+      if (_bars[i].status || progress.refresh (_bars[i].value))
+        draw (i);
+    }
+  }
+
+  write ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The last value of a bar, or the minimum for a new one.
+long Board::value (const std::string& name) const
+{
+  auto index = find (name);
+  return index == -1 ? _prototype.minimum : _bars[index].value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Board::pending () const
+{
+  for (auto& bar : _bars)
+    if (bar.progress->pending ())
+      return true;
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Whether the terminal has yet to take the output, and so should be watched
+// until it can, at which point a tick catches up.
+bool Board::congested () const
+{
+  return _out.congested () || _stale;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Leaves the cursor on the line after the last line still shown, so that the
+// lines left blank by removed bars and status lines are written over by what
+// follows.  The bars still shown end with the input, so their final events are
+// written.
+void Board::done ()
+{
+  if (_prototype.events != -1)
+    for (auto& bar : _bars)
+      if (! bar.finished && ! bar.status)
+        bar.progress->report (bar.value, true);
+
+  if (_prototype.trace)
+    for (auto& bar : _bars)
+      if (! bar.finished && ! bar.status)
+        bar.progress->record (bar.value, true);
+
+  if (_prototype.metrics)
+    for (auto& bar : _bars)
+      if (! bar.finished && ! bar.status)
+        bar.progress->publish (bar.value, true);
+
+  if (_tty && _lines)
+  {
+    if (_stale)
+      repaint ();
+
+    for (int i = 0; i < (int) _bars.size (); ++i)
+    {
+      auto& progress = *_bars[i].progress;
+      if (_bars[i].status)
+      {
+        if (_prototype.remove)
+        {
+          move (i);
+          _output += "\033[2K";
+        }
+      }
+      else if (_prototype.remove)
+      {
+        progress.erase ();
+        draw (i);
+      }
+      else if (progress.flush ())
+        draw (i);
+    }
+
+    move (std::max (1, (int) _bars.size ()) - 1);
+    _output += "\n";
+    _out.finish (_prototype.fd, _output.data (), _output.length ());
+    _output.clear ();
+  }
+
+  // The times between updates are summarized below the block.
+  if (_prototype.steps)
+  {
+    std::string summaries;
+    for (auto& bar : _bars)
+      if (! bar.status)
+        summaries += bar.progress->summary ();
+
+    _out.finish (_prototype.fd, summaries.data (), summaries.length ());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Board::find (const std::string& name) const
+{
+  for (int i = 0; i < (int) _bars.size (); ++i)
+    if (_bars[i].name == name)
+      return i;
+
+  return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Adds a bar at the bottom of the block, which only grows when there is no
+// line left behind by a removed bar.  The terminal line is made when the bar is
+// first drawn.
+int Board::add (const std::string& name, long value, bool status)
+{
+  _bars.push_back ({name, value, false, status, "", std::unique_ptr <Progress> (new Progress (_prototype))});
+  int index = _bars.size () - 1;
+
+  if (index >= _lines)
+    ++_lines;
+
+  relabel ();
+  return index;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Labels are padded to the same width, so that the bars line up, and a bar is
+// redrawn whenever its label changes.  Status lines have no label.
+void Board::relabel ()
+{
+  size_t width = 0;
+  for (auto& bar : _bars)
+    if (! bar.status)
+      width = std::max (width, (bar.name.length () ? bar.name : _prototype.label).length ());
+
+  for (int i = 0; i < (int) _bars.size (); ++i)
+  {
+    auto& bar = _bars[i];
+    if (bar.status)
+      continue;
+
+    auto label = bar.name.length () ? bar.name : _prototype.label;
+    if (label.length ())
+      label.resize (width, ' ');
+
+    if (bar.progress->label != label)
+    {
+      bar.progress->label = label;
+      bar.progress->invalidate ();
+      if (_tty && bar.progress->refresh (bar.value))
+        draw (i);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Moves the cursor up or down the block, to the start of a line, making the
+// terminal lines below the block that it does not have yet.
+void Board::move (int line)
+{
+  if (line >= _created)
+  {
+    move (_created - 1);
+    _output.append (line - _created + 1, '\n');
+    _created = line + 1;
+    _line = line;
+    return;
+  }
+
+  if (line < _line)
+    _output += "\033[" + std::to_string (_line - line) + "A";
+  else if (line > _line)
+    _output += "\033[" + std::to_string (line - _line) + "B";
+
+  _line = line;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A status line is cut to the width, counting UTF-8 characters, and control
+// characters are shown as spaces.
+void Board::draw (int index)
+{
+  move (index);
+  auto& bar = _bars[index];
+  if (bar.status)
+  {
+    int columns = 0;
+    for (auto c : bar.text)
+    {
+      auto byte = (unsigned char) c;
+      if ((byte & 0xC0) != 0x80 && ++columns > _prototype.width)
+        break;
+
+      _output += byte < 0x20 || byte == 0x7F ? ' ' : c;
+    }
+
+    _output += "\033[K\r";
+    return;
+  }
+
+  auto& frame = bar.progress->frame ();
+  _output.append (frame.data (), frame.size ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Clears every line of the block and draws every bar in full, for when the
+// terminal missed some output, and so shows nothing reliable.
+void Board::repaint ()
+{
+  _stale = false;
+  for (int i = 0; i < std::min (_lines, _created); ++i)
+  {
+    move (i);
+    _output += "\033[2K";
+    if (i < (int) _bars.size ())
+    {
+      if (! _bars[i].status)
+      {
+        _bars[i].progress->dropped ();
+        _bars[i].progress->flush ();
+      }
+
+      draw (i);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Everything that changed is emitted with a single write.  If the terminal is
+// too slow to take it, it is dropped, and the cursor is known to be where the
+// last output left it.  The bars are drawn again in full once the terminal
+// catches up.
+void Board::write ()
+{
+  if (_output.empty ())
+  {
+    _out.drain (_prototype.fd);
+    return;
+  }
+
+  if (_out.write (_prototype.fd, _output.data (), _output.length ()))
+  {
+    _shownLine = _line;
+    _shownCreated = _created;
+  }
+  else
+  {
+    _line = _shownLine;
+    _created = _shownCreated;
+    for (auto& bar : _bars)
+      if (! bar.status)
+        bar.progress->dropped ();
+
+    _stale = true;
+  }
+
+  _output.clear ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
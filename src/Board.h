@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_BOARD
+#define INCLUDED_BOARD
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <Progress.h>
+#include <Output.h>
+
+// Manages several named bars, each on its own line, in a block of terminal
+// lines, which may also hold lines of status text.  Only the bars that changed
+// are redrawn, by moving the cursor to their line.
+class Board
+{
+public:
+  explicit Board (const Progress&);
+
+  void update (const std::string&, long);
+  void finish (const std::string&);
+  void status (const std::string&, const std::string&);
+  void print (const std::string&);
+  void write ();
+  void tick ();
+  void resize (int);
+  long value (const std::string&) const;
+  bool pending () const;
+  bool congested () const;
+  void done ();
+
+private:
+  struct Bar
+  {
+    std::string name;
+    long value;
+    bool finished;
+    bool status;
+    std::string text;
+    std::unique_ptr <Progress> progress;
+  };
+
+  int find (const std::string&) const;
+  int add (const std::string&, long, bool);
+  void relabel ();
+  void move (int);
+  void draw (int);
+  void repaint ();
+
+private:
+  Progress _prototype;
+  std::vector <Bar> _bars {};
+  bool _tty               {false};
+  int _lines              {0};
+  int _line               {0};
+  int _created            {1};
+  int _shownLine          {0};
+  int _shownCreated       {1};
+  bool _stale             {false};
+  std::string _output     {};
+  Output _out             {};
+};
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
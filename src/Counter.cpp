@@ -0,0 +1,156 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Counter.h>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const uint32_t magic   = 0x56524d53;  // 'VRMS'
+static const uint32_t version = 1;
+
+////////////////////////////////////////////////////////////////////////////////
+// Attaches to a counter that was created by Counter::create.
+Counter::Counter (const std::string& name)
+{
+  auto fd = shm_open (path (name).c_str (), O_RDWR, 0);
+  if (fd == -1)
+    throw std::string ("The shared counter '") + name + "' does not exist.";
+
+  // A counter that is still being created may not be sized yet, and mapping
+  // past its end would fault on the first access.
+  struct stat info;
+  if (fstat (fd, &info) == -1 ||
+      info.st_size < (off_t) sizeof (Segment))
+  {
+    close (fd);
+    throw std::string ("The shared counter '") + name + "' is not initialized.";
+  }
+
+  auto address = mmap (nullptr, sizeof (Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close (fd);
+  if (address == MAP_FAILED)
+    throw std::string ("The shared counter '") + name + "' could not be mapped: " + strerror (errno);
+
+  auto segment = static_cast <Segment*> (address);
+  if (segment->magic   != magic ||
+      segment->version != version)
+  {
+    munmap (address, sizeof (Segment));
+    throw std::string ("The shared counter '") + name + "' is not initialized.";
+  }
+
+  _segment = segment;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Counter::~Counter ()
+{
+  if (_segment)
+    munmap (_segment, sizeof (Segment));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long Counter::add (long amount)
+{
+  return _segment->value.fetch_add (amount, std::memory_order_relaxed) + amount;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long Counter::value () const
+{
+  return _segment->value.load (std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long Counter::minimum () const
+{
+  return _segment->minimum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long Counter::maximum () const
+{
+  return _segment->maximum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+time_t Counter::start () const
+{
+  return _segment->start;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Creates, or resets, a counter at the minimum value.  The magic number is
+// written last, so that no process attaches to a half-initialized counter.
+void Counter::create (const std::string& name, long minimum, long maximum)
+{
+  static_assert (ATOMIC_LONG_LOCK_FREE == 2, "A shared counter needs a lock-free atomic long.");
+
+  auto fd = shm_open (path (name).c_str (), O_RDWR | O_CREAT, 0600);
+  if (fd == -1)
+    throw std::string ("The shared counter '") + name + "' could not be created: " + strerror (errno);
+
+  if (ftruncate (fd, sizeof (Segment)) == -1)
+  {
+    close (fd);
+    throw std::string ("The shared counter '") + name + "' could not be sized: " + strerror (errno);
+  }
+
+  auto address = mmap (nullptr, sizeof (Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close (fd);
+  if (address == MAP_FAILED)
+    throw std::string ("The shared counter '") + name + "' could not be mapped: " + strerror (errno);
+
+  auto segment = static_cast <Segment*> (address);
+  segment->magic   = 0;
+  segment->version = version;
+  segment->minimum = minimum;
+  segment->maximum = maximum;
+  segment->start   = time (nullptr);
+  segment->value.store (minimum);
+  std::atomic_thread_fence (std::memory_order_release);
+  segment->magic   = magic;
+
+  munmap (address, sizeof (Segment));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Counter::unlink (const std::string& name)
+{
+  shm_unlink (path (name).c_str ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string Counter::path (const std::string& name)
+{
+  return "/vramsteg-" + name;
+}
+
+////////////////////////////////////////////////////////////////////////////////
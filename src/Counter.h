@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_COUNTER
+#define INCLUDED_COUNTER
+
+#include <string>
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+
+// A progress counter in a named shared memory segment, which any number of
+// cooperating processes can advance with a single atomic operation, while
+// another process draws the bar.
+class Counter
+{
+public:
+  explicit Counter (const std::string&);
+  ~Counter ();
+  Counter (const Counter&) = delete;
+  Counter& operator= (const Counter&) = delete;
+
+  long add (long);
+  long value () const;
+  long minimum () const;
+  long maximum () const;
+  time_t start () const;
+
+  static void create (const std::string&, long, long);
+  static void unlink (const std::string&);
+
+private:
+  struct Segment
+  {
+    uint32_t           magic;
+    uint32_t           version;
+    long               minimum;
+    long               maximum;
+    time_t             start;
+    std::atomic <long> value;
+  };
+
+  static std::string path (const std::string&);
+
+private:
+  Segment* _segment {nullptr};
+};
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Format.h>
+#include <algorithm>
+
+////////////////////////////////////////////////////////////////////////////////
+// Literal braces are doubled: '{{' and '}}'.
+void Format::compile (const std::string& input)
+{
+  _steps.clear ();
+
+  std::string text;
+  for (std::string::size_type i = 0; i < input.length (); ++i)
+  {
+    if (input.compare (i, 2, "{{") == 0 || input.compare (i, 2, "}}") == 0)
+      text += input[i++];
+
+    else if (input[i] == '{')
+    {
+      auto end = input.find ('}', i);
+      if (end == std::string::npos)
+        throw std::string ("Format '") + input + "' has an unmatched '{'.";
+
+      if (text.length ())
+        _steps.push_back ({Text, text, "", ' ', ' ', nullptr, nullptr});
+      text.clear ();
+
+      field (input.substr (i + 1, end - i - 1));
+      i = end;
+    }
+
+    else if (input[i] == '}')
+      throw std::string ("Format '") + input + "' has an unmatched '}'.";
+
+    else
+      text += input[i];
+  }
+
+  if (text.length ())
+    _steps.push_back ({Text, text, "", ' ', ' ', nullptr, nullptr});
+
+  if (std::count_if (_steps.begin (), _steps.end (), [] (const Step& s) { return s.field == Bar; }) > 1)
+    throw std::string ("Format '") + input + "' has more than one bar.";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Format::uses (Field field) const
+{
+  return std::any_of (_steps.begin (), _steps.end (), [field] (const Step& s) { return s.field == field; });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const std::vector <Format::Step>& Format::steps () const
+{
+  return _steps;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The template for a named style.  They differ only in the bar:
+//
+// label GGGGGGGGRRRRRRRRRRRRRRRRR  34% 0:12 0:35    Default (green and red)
+// label WWWWWWWWBBBBBBBBBBBBBBBBB  34% 0:12 0:35    Mono (white and black)
+// label [********                ]  34% 0:12 0:35   Text
+std::string Format::style (const std::string& name)
+{
+       if (name == "")     return "{label }{bar}{ pct}{ rate}{ min}{/avg}{/p50}{/p99}{ elapsed}{ eta}";
+  else if (name == "mono") return "{label }{bar:mono}{ pct}{ rate}{ min}{/avg}{/p50}{/p99}{ elapsed}{ eta}";
+  else if (name == "text") return "{label }[{bar:*}]{ pct}{ rate}{ min}{/avg}{/p50}{/p99}{ elapsed}{ eta}";
+
+  throw std::string ("Style '") + name + "' not supported.";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Parses the inside of a pair of braces: text, a field name, and then either
+// more text, or for the bar, a colon and its appearance.  A bar is colored
+// green and red by default, white and black for 'mono', or drawn with one or
+// two characters, such as '*' or '#-', for the done and remaining parts.
+void Format::field (const std::string& inside)
+{
+  auto start = inside.find_first_of ("abcdefghijklmnopqrstuvwxyz");
+  if (start == std::string::npos)
+    throw std::string ("Format field '{") + inside + "}' has no name.";
+
+  auto end = inside.find_first_not_of ("abcdefghijklmnopqrstuvwxyz0123456789", start);
+  if (end == std::string::npos)
+    end = inside.length ();
+
+  auto name = inside.substr (start, end - start);
+  Step step {Text, inside.substr (0, start), inside.substr (end), ' ', ' ', nullptr, nullptr};
+
+       if (name == "label")   step.field = Label;
+  else if (name == "bar")     step.field = Bar;
+  else if (name == "pct")     step.field = Percent;
+  else if (name == "rate")    step.field = Rate;
+  else if (name == "elapsed") step.field = Elapsed;
+  else if (name == "eta")     step.field = Estimate;
+  else if (name == "min")     step.field = StepMinimum;
+  else if (name == "avg")     step.field = StepAverage;
+  else if (name == "p50")     step.field = StepMedian;
+  else if (name == "p99")     step.field = StepTail;
+  else
+    throw std::string ("Format field '") + name + "' not supported.";
+
+  if (step.field == Bar)
+  {
+    auto look = step.after.length () && step.after[0] == ':' ? step.after.substr (1) : "";
+    if (step.after.length () && step.after[0] != ':')
+      throw std::string ("Format field '{") + inside + "}' cannot have text after the bar.";
+
+    step.after.clear ();
+    if (look == "")
+    {
+      step.doneAttr = "\033[42m"; // Green
+      step.leftAttr = "\033[41m"; // Red
+    }
+    else if (look == "mono")
+    {
+      step.doneAttr = "\033[47m"; // White
+      step.leftAttr = "\033[40m"; // Black
+    }
+    else if (look.length () <= 2)
+    {
+      step.done = look[0];
+      step.left = look.length () == 2 ? look[1] : ' ';
+    }
+    else
+      throw std::string ("Format bar '") + look + "' not supported.";
+  }
+
+  _steps.push_back (step);
+}
+
+////////////////////////////////////////////////////////////////////////////////
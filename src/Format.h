@@ -0,0 +1,69 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_FORMAT
+#define INCLUDED_FORMAT
+
+#include <string>
+#include <vector>
+
+// Parses a template such as '{label }[{bar:*}]{ pct}' into a list of steps,
+// once, so that drawing a frame only has to follow the list.  Text inside the
+// braces around a field name is shown along with the field, and only when it
+// is.  The styles are predefined templates.
+class Format
+{
+public:
+  enum Field {Text, Label, Bar, Percent, Rate, Elapsed, Estimate,
+              StepMinimum, StepAverage, StepMedian, StepTail};
+
+  struct Step
+  {
+    Field       field;
+    std::string before;     // The text itself, for Text
+    std::string after;
+    char        done;       // Bar cells, and their attributes
+    char        left;
+    const char* doneAttr;
+    const char* leftAttr;
+  };
+
+  void compile (const std::string&);
+  bool uses (Field) const;
+  const std::vector <Step>& steps () const;
+
+  static std::string style (const std::string&);
+
+private:
+  void field (const std::string&);
+
+private:
+  std::vector <Step> _steps {};
+};
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,323 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Frame.h>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+
+////////////////////////////////////////////////////////////////////////////////
+// Starts a new row.  The row last composed is only a reliable picture of the
+// terminal if it was also encoded.
+void Frame::clear ()
+{
+  _row = 1 - _row;
+  _known = _encoded;
+  _encoded = false;
+  _cells[_row] = 0;
+  _attribute = nullptr;
+  _size = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Sets the SGR sequence for the cells that follow, or nullptr for none.
+void Frame::attribute (const char* sgr)
+{
+  _attribute = sgr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Frame::text (const char* value)
+{
+  append (value, strlen (value));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Frame::text (const std::string& value)
+{
+  append (value.data (), value.length ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Frame::fill (char c, int count)
+{
+  if (count <= 0)
+    return;
+
+  auto& cells = _cells[_row];
+  if (cells + count > capacity)
+    throw std::string ("The specified width is too large.");
+
+  memset (_text[_row] + cells, c, count);
+  std::fill (_attr[_row] + cells, _attr[_row] + cells + count, _attribute);
+  cells += count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Right-aligns the value, space-padded, in at least the given width.
+void Frame::number (long value, int width)
+{
+  char digits[24];
+  auto end = digits + sizeof (digits);
+  auto p = end;
+
+  auto magnitude = value < 0 ? -(unsigned long) value : (unsigned long) value;
+  do
+  {
+    *--p = '0' + magnitude % 10;
+    magnitude /= 10;
+  }
+  while (magnitude);
+
+  if (value < 0)
+    *--p = '-';
+
+  fill (' ', width - (end - p));
+  append (p, end - p);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Formats as 'MM:SS', 'H:MM:SS' or 'Dd H:MM:SS'.
+void Frame::time (time_t t)
+{
+  if (t < 0)
+    t = 0;
+
+  long days    =  t          / 86400;
+  long hours   = (t % 86400) / 3600;
+  long minutes = (t %  3600) / 60;
+  long seconds =  t % 60;
+
+  if (days)
+  {
+    number (days, 0);
+    append ("d ", 2);
+  }
+
+  if (days || hours)
+  {
+    number (hours, 0);
+    append (":", 1);
+  }
+
+  char pairs[5] {char ('0' + minutes / 10), char ('0' + minutes % 10), ':',
+                 char ('0' + seconds / 10), char ('0' + seconds % 10)};
+  append (pairs, sizeof (pairs));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Encodes the row, leaving the cursor at the start of the line.
+void Frame::encode ()
+{
+  if (_known)
+  {
+    encodeChanges ();
+
+    // Repainting everything is occasionally cheaper.
+    auto changes = _size;
+    encodeFull ();
+    if (changes < _size)
+      encodeChanges ();
+  }
+  else
+    encodeFull ();
+
+  _encoded = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Forgets the previous row, so that the next one is encoded in full.  Needed
+// whenever the terminal may not show what was last encoded.
+void Frame::invalidate ()
+{
+  _known = false;
+  _encoded = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Appends raw bytes to the encoded output.
+void Frame::emit (const char* value)
+{
+  output (value, strlen (value));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const char* Frame::data () const
+{
+  return _buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+size_t Frame::size () const
+{
+  return _size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Number of characters that time () produces for the same value.
+int Frame::timeWidth (time_t t)
+{
+  if (t < 0)
+    t = 0;
+
+  auto digits = [] (long value)
+  {
+    int count = 1;
+    while (value >= 10)
+    {
+      value /= 10;
+      ++count;
+    }
+
+    return count;
+  };
+
+  long days  =  t          / 86400;
+  long hours = (t % 86400) / 3600;
+
+  if (days)
+    return digits (days) + 2 + digits (hours) + 6;
+
+  if (hours)
+    return digits (hours) + 6;
+
+  return 5;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Frame::append (const char* value, size_t length)
+{
+  auto& cells = _cells[_row];
+  if (cells + (int) length > capacity)
+    throw std::string ("The specified width is too large.");
+
+  memcpy (_text[_row] + cells, value, length);
+  std::fill (_attr[_row] + cells, _attr[_row] + cells + length, _attribute);
+  cells += length;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Whether a cell is unchanged from the previous row.  Cells beyond the end of
+// a row are blank.
+bool Frame::same (int i) const
+{
+  auto previous = 1 - _row;
+  auto now_text  = i < _cells[_row]     ? _text[_row][i]     : ' ';
+  auto now_attr  = i < _cells[_row]     ? _attr[_row][i]     : nullptr;
+  auto then_text = i < _cells[previous] ? _text[previous][i] : ' ';
+  auto then_attr = i < _cells[previous] ? _attr[previous][i] : nullptr;
+
+  return now_text == then_text && now_attr == then_attr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Outputs one cell, preceded by an SGR sequence if its attribute differs from
+// the one in effect.
+void Frame::put (int i, const char*& current)
+{
+  auto text = i < _cells[_row] ? _text[_row][i] : ' ';
+  auto attr = i < _cells[_row] ? _attr[_row][i] : nullptr;
+
+  if (attr != current)
+  {
+    emit (attr ? attr : "\033[0m");
+    current = attr;
+  }
+
+  output (&text, 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Frame::output (const char* value, size_t length)
+{
+  if (_size + length > sizeof (_buffer))
+    throw std::string ("The specified width is too large.");
+
+  memcpy (_buffer + _size, value, length);
+  _size += length;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Outputs every cell, and blanks any that remain from a longer previous row.
+void Frame::encodeFull ()
+{
+  _size = 0;
+
+  auto end = _known ? std::max (_cells[_row], _cells[1 - _row]) : _cells[_row];
+  const char* current = nullptr;
+  for (int i = 0; i < end; ++i)
+    put (i, current);
+
+  if (current)
+    emit ("\033[0m");
+
+  emit ("\r");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Outputs only the runs of changed cells, and moves the cursor over the rest.
+// Runs separated by a few unchanged cells are merged, because repeating those
+// cells is no more expensive than the escape sequence that skips them.
+void Frame::encodeChanges ()
+{
+  _size = 0;
+
+  auto end = std::max (_cells[_row], _cells[1 - _row]);
+  const char* current = nullptr;
+  int column = 0;
+
+  for (int i = 0; i < end; ++i)
+  {
+    if (same (i))
+      continue;
+
+    auto last = i;
+    for (int j = i + 1; j < end && j - last <= 4; ++j)
+      if (! same (j))
+        last = j;
+
+    if (i > column)
+    {
+      char move[16];
+      auto length = snprintf (move, sizeof (move), "\033[%dC", i - column);
+      output (move, length);
+    }
+
+    for (int k = i; k <= last; ++k)
+      put (k, current);
+
+    column = last + 1;
+    i = last;
+  }
+
+  if (current)
+    emit ("\033[0m");
+
+  if (column)
+    emit ("\r");
+}
+
+////////////////////////////////////////////////////////////////////////////////
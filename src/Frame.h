@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_FRAME
+#define INCLUDED_FRAME
+
+#include <string>
+#include <cstddef>
+#include <ctime>
+
+// Composes one line of output as a row of cells, without allocating.  The
+// row is then encoded either in full, or as only those cells that differ from
+// the previously encoded row, and emitted with a single write.
+class Frame
+{
+public:
+  void clear ();
+  void attribute (const char*);
+  void text (const char*);
+  void text (const std::string&);
+  void fill (char, int);
+  void number (long, int);
+  void time (time_t);
+
+  void encode ();
+  void invalidate ();
+  void emit (const char*);
+
+  const char* data () const;
+  size_t size () const;
+
+  static int timeWidth (time_t);
+
+private:
+  void append (const char*, size_t);
+  bool same (int) const;
+  void put (int, const char*&);
+  void output (const char*, size_t);
+  void encodeFull ();
+  void encodeChanges ();
+
+private:
+  static const int capacity = 2048;
+
+  // Two rows of cells: the one being composed, and the one last encoded.
+  char        _text[2][capacity];
+  const char* _attr[2][capacity];
+  int         _cells[2]  {0, 0};
+  int         _row       {0};
+  bool        _known     {false};
+  bool        _encoded   {false};
+  const char* _attribute {nullptr};
+
+  // The encoded output.
+  char   _buffer[16384];
+  size_t _size {0};
+};
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Histogram.h>
+#include <cstdio>
+
+////////////////////////////////////////////////////////////////////////////////
+void Histogram::add (int64_t duration)
+{
+  if (duration < 0)
+    duration = 0;
+
+  ++_counts[index (duration)];
+  if (_count == 0 || duration < _minimum) _minimum = duration;
+  if (_count == 0 || duration > _maximum) _maximum = duration;
+  _total += duration;
+  ++_count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+uint64_t Histogram::count () const
+{
+  return _count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int64_t Histogram::minimum () const
+{
+  return _minimum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int64_t Histogram::maximum () const
+{
+  return _maximum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int64_t Histogram::mean () const
+{
+  return _count ? (int64_t) (_total / _count) : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The middle of the bucket holding the given fraction of the durations, which
+// is never beyond the exact minimum or maximum.
+int64_t Histogram::percentile (double fraction) const
+{
+  if (_count == 0)
+    return 0;
+
+  auto rank = (uint64_t) (fraction * _count + 0.5);
+  if (rank < 1)      rank = 1;
+  if (rank > _count) rank = _count;
+
+  uint64_t seen = 0;
+  int i = 0;
+  while ((seen += _counts[i]) < rank)
+    ++i;
+
+  auto middle = (lowest (i) + lowest (i + 1) - 1) / 2;
+  return middle < _minimum ? _minimum
+       : middle > _maximum ? _maximum
+       :                     middle;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Rounds to the precision that format shows, so that a change is only seen
+// when it would be visible.
+int64_t Histogram::round (int64_t ns)
+{
+  static const int64_t limits[] {1000, 10000, 1000000, 10000000, 1000000000,
+                                 10000000000, 1000000000000};
+  static const int64_t units[]  {1, 100, 1000, 100000, 1000000,
+                                 100000000, 1000000000, 60000000000};
+
+  int i = 0;
+  while (i < 7 && ns >= limits[i])
+    ++i;
+
+  return (ns + units[i] / 2) / units[i] * units[i];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// At most five characters, with a unit, such as '850ns', '1.2ms' or '12s'.
+std::string Histogram::format (int64_t ns)
+{
+  char text[24];
+       if (ns < 1000)          snprintf (text, sizeof (text), "%dns",   (int) ns);
+  else if (ns < 10000)         snprintf (text, sizeof (text), "%.1fus", ns / 1e3);
+  else if (ns < 1000000)       snprintf (text, sizeof (text), "%dus",   (int) (ns / 1000));
+  else if (ns < 10000000)      snprintf (text, sizeof (text), "%.1fms", ns / 1e6);
+  else if (ns < 1000000000)    snprintf (text, sizeof (text), "%dms",   (int) (ns / 1000000));
+  else if (ns < 10000000000)   snprintf (text, sizeof (text), "%.1fs",  ns / 1e9);
+  else if (ns < 1000000000000) snprintf (text, sizeof (text), "%ds",    (int) (ns / 1000000000));
+  else                         snprintf (text, sizeof (text), "%dm",    (int) (ns / 60000000000));
+
+  return text;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Durations below 16ns have a bucket each.  Above that, each doubling is split
+// into 16 buckets, by the four bits after the leading one.
+int Histogram::index (int64_t ns)
+{
+  if (ns < sub)
+    return ns;
+
+  auto exponent = 63 - __builtin_clzll (ns);
+  auto i = (exponent - 3) * sub + (int) ((ns >> (exponent - 4)) - sub);
+  return i < buckets ? i : buckets - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The smallest duration in a bucket.
+int64_t Histogram::lowest (int i)
+{
+  if (i < sub)
+    return i;
+
+  auto exponent = i / sub + 3;
+  return (int64_t) (sub + i % sub) << (exponent - 4);
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_HISTOGRAM
+#define INCLUDED_HISTOGRAM
+
+#include <string>
+#include <cstdint>
+
+// Counts durations in buckets that are 16 to each doubling, as HDR histograms
+// do, so that any percentile is known to within about 6%, in fixed memory and
+// at the cost of a few instructions per duration.  The minimum, maximum and
+// mean are exact.
+class Histogram
+{
+public:
+  void add (int64_t);
+  uint64_t count () const;
+  int64_t minimum () const;
+  int64_t maximum () const;
+  int64_t mean () const;
+  int64_t percentile (double) const;
+
+  static int64_t round (int64_t);
+  static std::string format (int64_t);
+
+private:
+  static int index (int64_t);
+  static int64_t lowest (int);
+
+private:
+  static const int sub     = 16;             // Buckets per doubling
+  static const int buckets = (44 - 3) * sub; // Up to 2^44ns, about 4.9 hours
+
+  uint64_t _counts[buckets] {};
+  uint64_t _count           {0};
+  int64_t  _minimum         {0};
+  int64_t  _maximum         {0};
+  double   _total           {0.0};
+};
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,210 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <Metrics.h>
+#include <main.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// The gauges, in the order they are written.
+static const struct
+{
+  const char* name;
+  const char* help;
+}
+gauges[] =
+{
+  {"vramsteg_value",                         "Current value of the progress bar."},
+  {"vramsteg_minimum",                       "Value at 0%."},
+  {"vramsteg_maximum",                       "Value at 100%."},
+  {"vramsteg_fraction",                      "Fraction of the range completed, from 0 to 1."},
+  {"vramsteg_rate",                          "Rate of progress, in units per second."},
+  {"vramsteg_eta_seconds",                   "Estimated time remaining, NaN while unknown."},
+  {"vramsteg_done",                          "1 once the bar is done, otherwise 0."},
+  {"vramsteg_last_update_timestamp_seconds", "Time of the last update, for spotting stalls."},
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// A Prometheus sample value.
+static std::string number (double value)
+{
+  if (std::isnan (value))
+    return "NaN";
+
+  char buffer[32];
+  snprintf (buffer, sizeof (buffer), "%.15g", value);
+  return buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Metrics::Metrics (const std::string& path, int interval)
+: _path (path)
+, _interval (interval)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Registers a bar, returning the number that its updates carry.
+int Metrics::bar (const std::string& label)
+{
+  _bars.push_back ({label, 0, 0, 0, 0.0, 0.0, -1.0, false, 0.0});
+  return _bars.size () - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A final update is written at once, whatever the interval.
+void Metrics::update (int bar, long value, long minimum, long maximum,
+                      double fraction, double rate, double eta, bool done, bool final)
+{
+  if (_failed)
+    return;
+
+  struct timespec wall;
+  clock_gettime (CLOCK_REALTIME, &wall);
+
+  _bars[bar] = {_bars[bar].label, value, minimum, maximum, fraction, rate, eta, done,
+                wall.tv_sec + wall.tv_nsec / 1e9};
+
+  if (! due (final))
+    return;
+
+  try
+  {
+    write ();
+  }
+
+  catch (const std::string& e)
+  {
+    fprintf (stderr, "Error: %s.  No more metrics will be written.\n", e.c_str ());
+    _failed = true;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Whether an interval has passed since the file was last written.  Before this
+// process has written it, the file itself tells, so that a script that runs
+// vramsteg for every update does not write it every time either.
+bool Metrics::due (bool final)
+{
+  auto now = std::chrono::steady_clock::now ();
+  if (final || (_written != std::chrono::steady_clock::time_point {} &&
+               now - _written >= std::chrono::milliseconds (_interval)))
+    return true;
+
+  if (_written == std::chrono::steady_clock::time_point {})
+  {
+    struct stat info;
+    return stat (_path.c_str (), &info) == -1 || ! changedWithin (info, _interval);
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writes every gauge to a temporary file in the same directory, so that the
+// rename that replaces the file is atomic.
+void Metrics::write ()
+{
+  std::string out;
+  for (size_t g = 0; g < sizeof (gauges) / sizeof (gauges[0]); ++g)
+  {
+    out += std::string ("# HELP ") + gauges[g].name + " " + gauges[g].help + "\n"
+         + "# TYPE " + gauges[g].name + " gauge\n";
+
+    for (auto& bar : _bars)
+    {
+      double values[] {(double) bar.value,
+                       (double) bar.minimum,
+                       (double) bar.maximum,
+                       bar.fraction,
+                       bar.rate,
+                       bar.eta < 0 ? NAN : bar.eta,
+                       bar.done ? 1.0 : 0.0,
+                       bar.updated};
+
+      std::string label;
+      for (auto c : bar.label)
+      {
+        if (c == '\\' || c == '"')
+          label += '\\';
+
+        if (c == '\n')
+          label += "\\n";
+        else
+          label += c;
+      }
+
+      out += std::string (gauges[g].name) + "{label=\"" + label + "\"} " + number (values[g]) + "\n";
+    }
+  }
+
+  std::string name = _path + ".XXXXXX";
+  auto fd = mkstemp (&name[0]);
+  if (fd == -1)
+    throw std::string ("The metrics file '") + _path + "' could not be written: " + strerror (errno);
+
+  // The collector may run as another user.
+  auto written = fchmod (fd, 0644) == 0;
+  try
+  {
+    written = written && writeAll (fd, out.data (), out.length ());
+  }
+
+  catch (...)
+  {
+    written = false;
+  }
+
+  auto error = errno;
+  if (close (fd) == -1 && written)
+  {
+    written = false;
+    error = errno;
+  }
+
+  if (written && rename (name.c_str (), _path.c_str ()) == -1)
+  {
+    written = false;
+    error = errno;
+  }
+
+  if (! written)
+  {
+    unlink (name.c_str ());
+    throw std::string ("The metrics file '") + _path + "' could not be written: " + strerror (error);
+  }
+
+  _written = std::chrono::steady_clock::now ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,77 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_METRICS
+#define INCLUDED_METRICS
+
+#include <string>
+#include <vector>
+#include <chrono>
+
+// Keeps the latest values of the bars as Prometheus gauges in a file, for the
+// textfile collector of node_exporter.  The file is replaced atomically, by
+// writing a temporary file beside it and renaming it, so a scrape never sees
+// a partial file, and no more than once per interval, although a bar that is
+// done is always written.  A file that cannot be written is reported once, and
+// then no longer written, as metrics must never stop the work they report on.
+class Metrics
+{
+public:
+  Metrics (const std::string&, int);
+  Metrics (const Metrics&) = delete;
+  Metrics& operator= (const Metrics&) = delete;
+
+  int bar (const std::string&);
+  void update (int, long, long, long, double, double, double, bool, bool);
+
+private:
+  struct Bar
+  {
+    std::string label;
+    long value;
+    long minimum;
+    long maximum;
+    double fraction;
+    double rate;
+    double eta;         // Negative while unknown
+    bool done;
+    double updated;     // Seconds since the epoch
+  };
+
+  bool due (bool);
+  void write ();
+
+private:
+  std::string _path;
+  int _interval           {1000};
+  std::vector <Bar> _bars {};
+  bool _failed            {false};
+  std::chrono::steady_clock::time_point _written {};
+};
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
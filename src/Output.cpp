@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Output.h>
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Sends the data, or as much as the terminal accepts now, keeping the rest.
+// Returns false if the terminal accepted none of it, in which case the data is
+// dropped.
+bool Output::write (int fd, const char* data, size_t size)
+{
+  if (! drain (fd))
+    return false;
+
+  return send (fd, data, size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Sends as much of the remainder as the terminal accepts now, and returns
+// whether it has all gone.
+bool Output::drain (int fd)
+{
+  if (_backlog.empty ())
+    return true;
+
+  std::string backlog;
+  backlog.swap (_backlog);
+  if (! send (fd, backlog.data (), backlog.size ()))
+    _backlog.swap (backlog);
+
+  return _backlog.empty ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Sends the remainder and then the data, waiting for the terminal as long as it
+// takes.  For the last frame, which must not be lost.
+void Output::finish (int fd, const char* data, size_t size)
+{
+  auto wait = [fd] ()
+  {
+    struct pollfd writable {fd, POLLOUT, 0};
+    return poll (&writable, 1, -1) != -1 || errno == EINTR;
+  };
+
+  while (! drain (fd))
+    if (! wait ())
+      return;
+
+  while (! send (fd, data, size))
+    if (! wait ())
+      return;
+
+  while (! drain (fd))
+    if (! wait ())
+      return;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Output::congested () const
+{
+  return ! _backlog.empty ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writes until done, or until the terminal would block, keeping the remainder
+// of a partial write.  Other errors, such as a closed terminal, discard the
+// data, as there is nobody to show it to.
+bool Output::send (int fd, const char* data, size_t size)
+{
+  size_t written = 0;
+  while (written < size)
+  {
+    auto result = ::write (fd, data + written, size - written);
+    if (result == -1)
+    {
+      if (errno == EINTR)
+        continue;
+
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+      {
+        if (written == 0)
+          return false;
+
+        _backlog.assign (data + written, size - written);
+      }
+
+      return true;
+    }
+
+    written += result;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
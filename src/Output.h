@@ -0,0 +1,56 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_OUTPUT
+#define INCLUDED_OUTPUT
+
+#include <string>
+#include <cstddef>
+
+// Writes frames to a descriptor that may be non-blocking, so that a slow
+// terminal never holds up the caller.  Whatever part of a frame the terminal
+// does not accept at once is kept, and sent before anything else, because a
+// frame cut short would leave the terminal mid-sequence.  While that remainder
+// is outstanding, new frames are refused, and the caller draws a newer frame
+// in full once the terminal drains.
+class Output
+{
+public:
+  bool write (int, const char*, size_t);
+  bool drain (int);
+  void finish (int, const char*, size_t);
+  bool congested () const;
+
+private:
+  bool send (int, const char*, size_t);
+
+private:
+  std::string _backlog {};
+};
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
@@ -25,313 +25,685 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <Progress.h>
-#include <iostream>
-#include <sstream>
-#include <iomanip>
+#include <Trace.h>
+#include <main.h>
+#include <Metrics.h>
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <unistd.h>
 
+// Weights older samples of the rate by e^(-t/2), for t seconds of age.
+static const double rateTimeConstant = 2.0;
+
+////////////////////////////////////////////////////////////////////////////////
+// A JSON number, or null for a value that has none, such as a fraction of an
+// empty range.
+static std::string number (double value, const char* format)
+{
+  if (! std::isfinite (value))
+    return "null";
+
+  char buffer[32];
+  snprintf (buffer, sizeof (buffer), format, value);
+  return buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Widest rate: "999.9k/s" or "999.9KiB/s".
+static int rateWidth (bool bytes)
+{
+  return bytes ? 10 : 8;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
+// A frame that a slow terminal refuses is dropped, and a newer one drawn in
+// full later, so that drawing never waits for the terminal.  A frame that the
+// terminal already shows is not drawn, but the value is still reported.
 void Progress::update (long value)
 {
-  if (isatty (fileno (stdout)) && _current != value)
-  {
-    // Box the range.
-    if (value < minimum) value = minimum;
-    if (value > maximum) value = maximum;
+  if (steps)
+    measure ();
 
-    // Current value.
-    _current = value;
+  if (tty () && ! shown && refresh (value) && ! _output.write (fd, _frame.data (), _frame.size ()))
+    dropped ();
 
-    // Capable of supporting multiple styles.
-         if (style == "")     renderStyleDefault ();
-    else if (style == "mono") renderStyleMono ();
-    else if (style == "text") renderStyleText ();
-    else
-      throw std::string ("Style '") + style + "' not supported.";
-  }
+  if (events != -1)
+    report (value, false);
+
+  if (trace)
+    record (value, false);
+
+  if (metrics)
+    publish (value, false);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void Progress::done () const
+void Progress::done ()
 {
-  if (isatty (fileno (stdout)))
+  if (events != -1 && _reported != Instant {})
+    report (_current, true);
+
+  if (trace && _traced != -1)
+    record (_current, true);
+
+  if (metrics && _published != -1)
+    publish (_current, true);
+
+  if (tty ())
   {
+    // A throttled frame is still owed, unless it is about to be erased.
     if (remove)
-      std::cout << "\r"
-                << std::setfill (' ')
-                << std::setw (width)
-                << ' ';
+      erase ();
+    else if (! flush ())
+      _frame.clear ();
+
+    // The last frame is worth waiting for.
+    _frame.emit ("\n");
+    _output.finish (fd, _frame.data (), _frame.size ());
+    _frame.invalidate ();
+  }
 
-    std::cout << std::endl;
+  if (steps)
+  {
+    auto line = summary ();
+    _output.finish (fd, line.data (), line.length ());
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-std::string Progress::formatTime (time_t t) const
+// Composes the frame for a new value, but only when something visible changed,
+// and no more than fps times per second, although the final value is always
+// shown.  Returns whether there is a frame to emit.
+bool Progress::refresh (long value)
 {
-  char buffer [128];
+  if (! _compiled)
+    compile ();
+
+  // Box the range.
+  if (value < minimum) value = minimum;
+  if (value > maximum) value = maximum;
+
+  // Current value.
+  _current = value;
+
+  // Only a bar that shows times or rates, or is throttled, reads the clock.
+  auto now = elapsed || estimate || rate || fps > 0 ? std::chrono::steady_clock::now ()
+                                                     : Instant {};
+  begin (now);
+  sample (now);
+
+  auto next = snapshot (now);
+  if (next == _shown)
+    return false;
 
-  int days    =  t          / 86400;
-  int hours   = (t % 86400) / 3600;
-  int minutes = (t %  3600) / 60;
-  int seconds =  t % 60;
+  if (fps > 0                &&
+      _current != maximum    &&
+      now - _drawn < std::chrono::nanoseconds (1000000000 / fps))
+  {
+    _pending = true;
+    return false;
+  }
 
-  if (days)
-    snprintf (buffer, 128, "%dd %d:%02d:%02d", days, hours, minutes, seconds);
-  else if (hours)
-    snprintf (buffer, 128,     "%d:%02d:%02d",       hours, minutes, seconds);
+  render (next);
+  _shown   = next;
+  _drawn   = now;
+  _pending = false;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Composes the frame that was held back by throttling, if any.
+bool Progress::flush ()
+{
+  if (! _pending)
+    return false;
+
+  if (! _compiled)
+    compile ();
+
+  _shown = snapshot (std::chrono::steady_clock::now ());
+  render (_shown);
+  _pending = false;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writes an event describing the progress as a line of JSON to the events
+// descriptor, whether or not there is a terminal, but no more than once per
+// interval, although the first and final events are always written.  Where
+// the events descriptor does not block, as in the long-lived modes, events that
+// the reader is not ready for are dropped, like frames.
+void Progress::report (long value, bool final)
+{
+  if (value < minimum) value = minimum;
+  if (value > maximum) value = maximum;
+  _current = value;
+
+  auto now = std::chrono::steady_clock::now ();
+  begin (now);
+  sample (now);
+
+  if (! final                 &&
+      _reported != Instant {} &&
+      now - _reported < std::chrono::milliseconds (interval))
+    return;
+
+  _reported = now;
+
+  struct timespec wall;
+  clock_gettime (CLOCK_REALTIME, &wall);
+
+  auto seconds  = std::chrono::duration <double> (_offset + (now - _origin)).count ();
+  auto fraction = (1.0 * (_current - minimum)) / (maximum - minimum);
+  auto left     = final ? 0.0 : remaining (seconds, fraction);
+
+  // The label is padded to line up bars, which is of no interest here.
+  auto name = label.substr (0, label.find_last_not_of (' ') + 1);
+
+  std::string line = "{\"time\":"      + number (wall.tv_sec + wall.tv_nsec / 1e9, "%.3f")
+                   + ",\"label\":"     + jsonString (name)
+                   + ",\"value\":"     + std::to_string (_current)
+                   + ",\"minimum\":"   + std::to_string (minimum)
+                   + ",\"maximum\":"   + std::to_string (maximum)
+                   + ",\"fraction\":"  + number (fraction, "%.4f")
+                   + ",\"rate\":"      + number (perSecond (seconds), "%.3f")
+                   + ",\"eta\":"       + (left < 0 ? "null" : number (left, "%.0f"))
+                   + ",\"elapsed\":"   + number (seconds, "%.3f")
+                   + ",\"done\":"      + (final ? "true" : "false")
+                   + "}\n";
+
+  if (final)
+    _log.finish (events, line.data (), line.length ());
   else
-    snprintf (buffer, 128,        "%02d:%02d",              minutes, seconds);
+    _log.write (events, line.data (), line.length ());
+}
 
-  return std::string (buffer);
+////////////////////////////////////////////////////////////////////////////////
+// Adds the value to the trace, under the label without its padding.
+void Progress::record (long value, bool final)
+{
+  if (_traced == -1)
+    _traced = trace->bar (label.substr (0, label.find_last_not_of (' ') + 1), minimum, maximum);
+
+  if (value < minimum) value = minimum;
+  if (value > maximum) value = maximum;
+  _current = value;
+
+  trace->record (_traced, value, final);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Default style looks like this:
-//
-// label GGGGGGGGRRRRRRRRRRRRRRRRR  34% 0:12 0:35
-//
-// ^^^^^                                            Label string
-//       ^^^^^^^^                                   Completed bar (in green)
-//               ^^^^^^^^^^^^^^^^^                  Incomplete bar (in red)
-//                                 ^^^^             Percentage complete
-//                                      ^^^^        Elapsed time
-//                                           ^^^^   Remaining estimate
-void Progress::renderStyleDefault () const
+// Passes the latest values to the metrics, which decide when to write them.
+// A bar that reaches its maximum is done, and is always written.
+void Progress::publish (long value, bool final)
 {
-  // Fraction completed.
-  double fraction = (1.0 * (_current - minimum)) / (maximum - minimum);
+  if (value < minimum) value = minimum;
+  if (value > maximum) value = maximum;
+  _current = value;
 
-  // Elapsed time.
-  auto now = time (nullptr);
-  std::string elapsed_time;
-  if (elapsed && start != 0)
-    elapsed_time = formatTime (now - start);
+  auto now = std::chrono::steady_clock::now ();
+  begin (now);
+  sample (now);
 
-  // Estimated remaining time.
-  std::string estimate_time;
-  if (estimate && start != 0)
-  {
-    if (fraction >= 1e-6)
-      estimate_time = formatTime ((time_t) (int) (((now - start) * (1.0 - fraction)) / fraction));
-    else
-      estimate_time = formatTime (0);
-  }
+  if (_published == -1)
+    _published = metrics->bar (label.substr (0, label.find_last_not_of (' ') + 1));
 
-  // Calculate bar width.
-  auto bar = width
-           - (label.length () ? label.length () + 1         : 0)
-           - (percentage      ? 5                           : 0)
-           - (elapsed         ? elapsed_time.length () + 1  : 0)
-           - (estimate        ? estimate_time.length () + 1 : 0);
+  // A bar at its maximum shows as done, but only done () forces a write.
+  auto complete = final || _current == maximum;
 
-  if (bar < 1)
-    throw std::string ("The specified width is insufficient.");
+  auto seconds  = std::chrono::duration <double> (_offset + (now - _origin)).count ();
+  auto fraction = (1.0 * (_current - minimum)) / (maximum - minimum);
+  metrics->update (_published, _current, minimum, maximum, fraction,
+                   perSecond (seconds), complete ? 0.0 : remaining (seconds, fraction),
+                   complete, final);
+}
 
-  int visible = (int) (fraction * bar);
+////////////////////////////////////////////////////////////////////////////////
+// Adds the time since the previous update to the histogram.
+void Progress::measure ()
+{
+  auto now = std::chrono::steady_clock::now ();
+  if (_stepped != Instant {})
+    _intervals.add (std::chrono::duration_cast <std::chrono::nanoseconds> (now - _stepped).count ());
 
-  // Render.
-  if (label.length ())
-    std::cout << label
-              << ' ';
+  _stepped = now;
+}
 
-  if (visible > 0)
-    std::cout << "\033[42m" // Green
-              << std::setfill (' ')
-              << std::setw (visible)
-              << ' ';
+////////////////////////////////////////////////////////////////////////////////
+// A line describing the times between updates, for when the bar is done, or
+// nothing before there are two updates.
+std::string Progress::summary () const
+{
+  if (! _intervals.count ())
+    return "";
+
+  auto name = label.substr (0, label.find_last_not_of (' ') + 1);
+  return (name.length () ? name + ": " : "")
+       + std::to_string (_intervals.count ()) + " steps"
+       + ", min " + Histogram::format (Histogram::round (_intervals.minimum ()))
+       + ", avg " + Histogram::format (Histogram::round (_intervals.mean ()))
+       + ", p50 " + Histogram::format (Histogram::round (_intervals.percentile (0.5)))
+       + ", p99 " + Histogram::format (Histogram::round (_intervals.percentile (0.99)))
+       + ", max " + Histogram::format (Histogram::round (_intervals.maximum ()))
+       + "\n";
+}
 
-  if (bar - visible > 0)
-    std::cout << "\033[41m" // Red
-              << std::setfill (' ')
-              << std::setw (bar - visible)
-              << ' ';
+////////////////////////////////////////////////////////////////////////////////
+// Composes a frame that blanks the whole line, in full, because the bar being
+// erased may have been drawn by an earlier invocation.
+void Progress::erase ()
+{
+  _frame.invalidate ();
+  _frame.clear ();
+  _frame.fill (' ', width);
+  _frame.encode ();
+}
 
-  std::cout << "\033[0m";
+////////////////////////////////////////////////////////////////////////////////
+// Forgets what was drawn, for when the bar is moved or its terminal line is
+// overwritten, so that the next frame is composed in full.
+void Progress::invalidate ()
+{
+  _shown = Snapshot {};
+  _frame.invalidate ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The terminal did not show the last frame, so the next one is owed, and is
+// composed in full.
+void Progress::dropped ()
+{
+  invalidate ();
+  _pending = true;
+}
 
-  if (percentage)
-    std::cout << " "
-              << std::setfill (' ')
-              << std::setw (3)
-              << (int) (fraction * 100)
-              << "%";
+////////////////////////////////////////////////////////////////////////////////
+// Whether throttling, or a slow terminal, is holding back a frame.
+bool Progress::pending () const
+{
+  return _pending;
+}
 
-  if (elapsed && start != 0)
-    std::cout << " "
-              << elapsed_time;
+////////////////////////////////////////////////////////////////////////////////
+const Frame& Progress::frame () const
+{
+  return _frame;
+}
 
-  if (estimate && start != 0 && fraction > 0.2)
-    std::cout << " "
-              << estimate_time;
+////////////////////////////////////////////////////////////////////////////////
+// A hash of everything the frame for a value would show, which lets a later
+// process decide whether drawing that value would change anything.
+uint64_t Progress::signature (long value)
+{
+  if (value < minimum) value = minimum;
+  if (value > maximum) value = maximum;
+  _current = value;
+
+  if (! _compiled)
+    compile ();
+
+  auto now = std::chrono::steady_clock::now ();
+  begin (now);
+
+  auto s = snapshot (now);
 
-  std::cout << "\r"
-            << std::flush;
+  // FNV-1a.
+  uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash] (const void* data, size_t size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      hash = (hash ^ static_cast <const unsigned char*> (data)[i]) * 1099511628211ULL;
+  };
+
+  mix (style.c_str (), style.length () + 1);
+  mix (format.c_str (), format.length () + 1);
+  mix (label.c_str (), label.length () + 1);
+  mix (&width,        sizeof (width));
+  mix (&percentage,   sizeof (percentage));
+  mix (&s.bar,        sizeof (s.bar));
+  mix (&s.visible,    sizeof (s.visible));
+  mix (&s.percent,    sizeof (s.percent));
+  mix (&s.rate,       sizeof (s.rate));
+  mix (&s.scale,      sizeof (s.scale));
+  mix (&s.elapsed,    sizeof (s.elapsed));
+  mix (&s.estimate,   sizeof (s.estimate));
+  mix (&s.remaining,  sizeof (s.remaining));
+  mix (&s.fastest,    sizeof (s.fastest));
+  mix (&s.average,    sizeof (s.average));
+  mix (&s.median,     sizeof (s.median));
+  mix (&s.tail,       sizeof (s.tail));
+  return hash;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Mono style looks like this:
-//
-// label WWWWWWWWBBBBBBBBBBBBBBBBB  34% 0:12 0:35
-//
-// ^^^^^                                            Label string
-//       ^^^^^^^^                                   Completed bar (in white)
-//               ^^^^^^^^^^^^^^^^^                  Incomplete bar (in black)
-//                                 ^^^^             Percentage complete
-//                                      ^^^^        Elapsed time
-//                                           ^^^^   Remaining estimate
-void Progress::renderStyleMono () const
+// Compiles the format, or else the template of the style, into the steps that
+// render a frame, leaving out the fields that are not shown.  A format shows
+// exactly the fields that it names.  Needed again whenever the style, format
+// or fields change, but not the label or width.
+void Progress::compile ()
 {
-  // Fraction completed.
-  double fraction = (1.0 * (_current - minimum)) / (maximum - minimum);
+  _compiled = false;
 
-  // Elapsed time.
-  auto now = time (nullptr);
-  std::string elapsed_time;
-  if (elapsed && start != 0)
-    elapsed_time = formatTime (now - start);
+  Format compiled;
+  compiled.compile (format.length () ? format : Format::style (style));
+  if (format.length ())
+  {
+    percentage = compiled.uses (Format::Percent);
+    rate       = compiled.uses (Format::Rate);
+    elapsed    = compiled.uses (Format::Elapsed);
+    estimate   = compiled.uses (Format::Estimate);
+    steps      = compiled.uses (Format::StepMinimum) ||
+                 compiled.uses (Format::StepAverage) ||
+                 compiled.uses (Format::StepMedian)  ||
+                 compiled.uses (Format::StepTail);
+  }
 
-  // Estimated remaining time.
-  std::string estimate_time;
-  if (estimate && start != 0)
+  _program.clear ();
+  _fixed = 0;
+  _labelAffix = 0;
+  for (auto& step : compiled.steps ())
   {
-    if (fraction >= 1e-6)
-      estimate_time = formatTime ((time_t) (int) (((now - start) * (1.0 - fraction)) / fraction));
+    if ((step.field == Format::Percent  && ! percentage) ||
+        (step.field == Format::Rate     && ! rate)       ||
+        (step.field == Format::Elapsed  && ! elapsed)    ||
+        (step.field == Format::Estimate && ! estimate)   ||
+        (step.field >= Format::StepMinimum && ! steps))
+      continue;
+
+    auto affix = (int) (step.before.length () + step.after.length ());
+    if (step.field == Format::Label)
+      _labelAffix += affix;
     else
-      estimate_time = formatTime (0);
+      _fixed += affix
+              + (step.field == Format::Percent ? 4                 : 0)
+              + (step.field == Format::Rate    ? rateWidth (bytes) : 0)
+              + (step.field >= Format::StepMinimum ? 5             : 0);
+
+    _program.push_back (step);
   }
 
-  // Calculate bar width.
-  auto bar = width
-           - (label.length () ? label.length () + 1         : 0)
-           - (percentage      ? 5                           : 0)
-           - (elapsed         ? elapsed_time.length () + 1  : 0)
-           - (estimate        ? estimate_time.length () + 1 : 0);
+  // The default style only shows the estimate beyond 20%.
+  _bar      = compiled.uses (Format::Bar);
+  _delayed  = format.empty () && style.empty ();
+  _compiled = true;
+}
 
-  if (bar < 1)
-    throw std::string ("The specified width is insufficient.");
+////////////////////////////////////////////////////////////////////////////////
+// Whether the output is a terminal only needs to be determined once.
+bool Progress::tty ()
+{
+  if (_tty == -1)
+    _tty = isatty (fd);
 
-  int visible = (int) (fraction * bar);
+  return _tty == 1;
+}
 
-  // Render.
-  if (label.length ())
-    std::cout << label
-              << ' ';
+////////////////////////////////////////////////////////////////////////////////
+// Starts the monotonic clock at the first update.  The start time is in whole
+// seconds, so the offset includes the fraction of the current second, which
+// matches the elapsed time that the wall clock would give.
+void Progress::begin (Instant now)
+{
+  if (_origin != Instant {} || now == Instant {})
+    return;
 
-  if (visible > 0)
-    std::cout << "\033[47m" // White
-              << std::setfill (' ')
-              << std::setw (visible)
-              << ' ';
+  _origin = now;
+  if (start != 0)
+  {
+    struct timespec wall;
+    clock_gettime (CLOCK_REALTIME, &wall);
+    _offset = std::chrono::seconds (wall.tv_sec - start)
+            + std::chrono::nanoseconds (wall.tv_nsec);
+  }
+}
 
-  if (bar - visible > 0)
-    std::cout << "\033[40m" // Black
-              << std::setfill (' ')
-              << std::setw (bar - visible)
-              << ' ';
+////////////////////////////////////////////////////////////////////////////////
+// Folds the current value into the moving average of the rate.  Each sample
+// is weighted by the time since the previous one, so that irregular updates
+// count fairly, and updates less than 100ms apart are merged.
+void Progress::sample (Instant now)
+{
+  if (now == Instant {})
+    return;
 
-  std::cout << "\033[0m";
+  if (_sampled == Instant {})
+  {
+    _sampled      = now;
+    _sampledValue = _current;
+    return;
+  }
 
-  if (percentage)
-    std::cout << " "
-              << std::setfill (' ')
-              << std::setw (3)
-              << (int) (fraction * 100)
-              << "%";
+  auto interval = std::chrono::duration <double> (now - _sampled).count ();
+  if (interval < 0.1)
+    return;
 
-  if (elapsed && start != 0)
-    std::cout << " "
-              << elapsed_time;
+  auto instant = (_current - _sampledValue) / interval;
+  if (_rated)
+    _rate += (1.0 - exp (-interval / rateTimeConstant)) * (instant - _rate);
+  else
+    _rate = instant;
 
-  if (estimate && start != 0)
-    std::cout << " "
-              << estimate_time;
+  _rated        = true;
+  _sampled      = now;
+  _sampledValue = _current;
+}
 
-  std::cout << "\r"
-            << std::flush;
+////////////////////////////////////////////////////////////////////////////////
+bool Progress::Snapshot::operator== (const Snapshot& other) const
+{
+  return bar       == other.bar      &&
+         visible   == other.visible  &&
+         percent   == other.percent  &&
+         rate      == other.rate     &&
+         scale     == other.scale    &&
+         elapsed   == other.elapsed  &&
+         estimate  == other.estimate &&
+         remaining == other.remaining &&
+         fastest   == other.fastest  &&
+         average   == other.average  &&
+         median    == other.median   &&
+         tail      == other.tail;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Text style looks like this:
-//
-// label [********                ]  34% 0:12 0:35
-//
-// ^^^^^                                             Label string
-//        ^^^^^^^^                                   Completed bar
-//               ^^^^^^^^^^^^^^^^^                   Incomplete bar
-//                                  ^^^^             Percentage complete
-//                                       ^^^^        Elapsed time
-//                                            ^^^^   Remaining estimate
-void Progress::renderStyleText () const
+// The rate, from the moving average once there is one, or else the average
+// since the start.
+double Progress::perSecond (double seconds) const
 {
+  return _rated      ? _rate
+       : seconds > 0 ? (_current - minimum) / seconds
+       :               0.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Seconds left, at the current rate where it is known, or else extrapolated
+// from the progress so far, or -1 before there is any progress.
+double Progress::remaining (double seconds, double fraction) const
+{
+  if (_rated && _rate > 0)
+    return (maximum - _current) / _rate;
+
+  if (fraction >= 1e-6)
+    return (double) (int) ((seconds * (1.0 - fraction)) / fraction);
+
+  return -1.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Calculates everything that a frame would show, without rendering it.
+Progress::Snapshot Progress::snapshot (Instant now) const
+{
+  Snapshot s;
+
   // Fraction completed.
-  double fraction = (1.0 * (_current - minimum)) / (maximum - minimum);
+  s.fraction = (1.0 * (_current - minimum)) / (maximum - minimum);
+  s.percent = (int) (s.fraction * 100);
 
   // Elapsed time.
-  auto now = time (nullptr);
-  std::string elapsed_time;
+  auto running = _offset + (now - _origin);
+  auto seconds = std::chrono::duration <double> (running).count ();
+  int elapsed_width = 0;
   if (elapsed && start != 0)
-    elapsed_time = formatTime (now - start);
+  {
+    s.elapsed = std::chrono::duration_cast <std::chrono::seconds> (running).count ();
+    elapsed_width = Frame::timeWidth (s.elapsed);
+  }
 
-  // Estimated remaining time.
-  std::string estimate_time;
-  if (estimate && start != 0)
+  if (rate)
   {
-    if (fraction >= 1e-6)
-      estimate_time = formatTime ((time_t) (int) (((now - start) * (1.0 - fraction)) / fraction));
-    else
-      estimate_time = formatTime (0);
+    auto scaled = std::max (perSecond (seconds), 0.0);
+    while (scaled >= 999.95 && s.scale < 4)
+    {
+      scaled /= (bytes ? 1024 : 1000);
+      ++s.scale;
+    }
+
+    s.rate = (int) (scaled * 10 + 0.5);
   }
 
-  // Calculate bar width.
-  auto bar = width
-           - 2                                                    // The [ and ]
-           - (label.length () ? label.length () + 1         : 0)
-           - (percentage      ? 5                           : 0)
-           - (elapsed         ? elapsed_time.length () + 1  : 0)
-           - (estimate        ? estimate_time.length () + 1 : 0);
+  int estimate_width = 0;
+  if (estimate && start != 0)
+  {
+    s.estimate = (time_t) std::max (remaining (seconds, s.fraction), 0.0);
 
-  if (bar < 1)
-    throw std::string ("The specified width is insufficient.");
+    estimate_width = Frame::timeWidth (s.estimate);
+    s.remaining = ! _delayed || s.fraction > 0.2;
 
-  int visible = (int) (fraction * bar);
+    // Until it is shown, only the space reserved for it is visible.
+    if (! s.remaining)
+      s.estimate = -1;
+  }
 
-  // Render.
-  if (label.length ())
-    std::cout << label
-              << ' ';
+  if (steps && _intervals.count ())
+  {
+    s.fastest = Histogram::round (_intervals.minimum ());
+    s.average = Histogram::round (_intervals.mean ());
+    s.median  = Histogram::round (_intervals.percentile (0.5));
+    s.tail    = Histogram::round (_intervals.percentile (0.99));
+  }
 
-  std::cout << '[';
+  // The bar takes whatever width is left.
+  s.bar = width
+        - _fixed
+        - (label.length () ? label.length () + _labelAffix : 0)
+        - (elapsed         ? elapsed_width                 : 0)
+        - (estimate        ? estimate_width                : 0);
 
-  if (visible > 0)
-    std::cout << std::setfill ('*')
-              << std::setw (visible)
-              << '*';
+  if (! _bar)
+    s.bar = 0;
+  else if (s.bar < 1)
+    throw std::string ("The specified width is insufficient.");
 
-  if (bar - visible > 0)
-    std::cout << std::setfill (' ')
-              << std::setw (bar - visible)
-              << ' ';
+  s.visible = (int) (s.fraction * s.bar);
+  return s;
+}
 
-  std::cout << ']';
+////////////////////////////////////////////////////////////////////////////////
+// Follows the compiled steps.  Fields that are not shown yet leave no gap.
+void Progress::render (const Snapshot& s)
+{
+  _frame.clear ();
+  for (auto& step : _program)
+  {
+    switch (step.field)
+    {
+    case Format::Text:
+      _frame.text (step.before);
+      continue;
+
+    case Format::Label:
+      if (! label.length ())
+        continue;
+
+      _frame.text (step.before);
+      _frame.text (label);
+      break;
+
+    case Format::Bar:
+      _frame.text (step.before);
+      _frame.attribute (step.doneAttr);
+      _frame.fill (step.done, s.visible);
+      _frame.attribute (step.leftAttr);
+      _frame.fill (step.left, s.bar - s.visible);
+      _frame.attribute (nullptr);
+      break;
+
+    case Format::Percent:
+      _frame.text (step.before);
+      _frame.number (s.percent, 3);
+      _frame.text ("%");
+      break;
+
+    case Format::Rate:
+      _frame.text (step.before);
+      renderRate (s);
+      break;
+
+    case Format::Elapsed:
+      if (start == 0)
+        continue;
+
+      _frame.text (step.before);
+      _frame.time (s.elapsed);
+      break;
+
+    case Format::Estimate:
+      if (! s.remaining)
+        continue;
+
+      _frame.text (step.before);
+      _frame.time (s.estimate);
+      break;
+
+    case Format::StepMinimum:
+    case Format::StepAverage:
+    case Format::StepMedian:
+    case Format::StepTail:
+      _frame.text (step.before);
+      renderStep (step.field == Format::StepMinimum ? s.fastest
+                : step.field == Format::StepAverage ? s.average
+                : step.field == Format::StepMedian  ? s.median
+                :                                     s.tail);
+      break;
+    }
+
+    _frame.text (step.after);
+  }
 
-  if (percentage)
-    std::cout << " "
-              << std::setfill (' ')
-              << std::setw (3)
-              << (int) (fraction * 100)
-              << "%";
+  _frame.encode ();
+}
 
-  if (elapsed && start != 0)
-    std::cout << " "
-              << elapsed_time;
+////////////////////////////////////////////////////////////////////////////////
+// The rate has one decimal place, and a unit prefix, right-aligned in a field
+// of constant width, so that the bar does not change length:
+//
+//   12.5k/s      Items, with decimal prefixes
+//   3.2MiB/s     Bytes, with binary prefixes
+//
+void Progress::renderRate (const Snapshot& s)
+{
+  static const char* items[] = {"",  "k",   "M",   "G",   "T"};
+  static const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
 
-  if (estimate && start != 0)
-    std::cout << " "
-              << estimate_time;
+  char field[32];
+  auto length = snprintf (field, sizeof (field), "%d.%d%s/s",
+                          s.rate / 10,
+                          s.rate % 10,
+                          (bytes ? units : items)[s.scale]);
 
-  std::cout << "\r"
-            << std::flush;
+  _frame.fill (' ', rateWidth (bytes) - length);
+  _frame.text (field);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A time between updates, right-aligned in five characters, or a dash before
+// there are two updates.
+void Progress::renderStep (int64_t ns)
+{
+  auto text = ns < 0 ? std::string ("-") : Histogram::format (ns);
+  _frame.fill (' ', 5 - text.length ());
+  _frame.text (text);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
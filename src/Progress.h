@@ -28,22 +28,76 @@
 #define INCLUDED_PROGRESS
 
 #include <string>
+#include <chrono>
 #include <ctime>
+#include <cstdint>
+#include <unistd.h>
+#include <vector>
+#include <Format.h>
+#include <Frame.h>
+#include <Histogram.h>
+#include <Output.h>
+
+class Trace;
+class Metrics;
 
 class Progress
 {
 public:
   void update (long);
-  void done () const;
+  void done ();
+
+  bool refresh (long);
+  void report (long, bool);
+  void record (long, bool);
+  void publish (long, bool);
+  void measure ();
+  std::string summary () const;
+  bool flush ();
+  void erase ();
+  void invalidate ();
+  void dropped ();
+  bool pending () const;
+  const Frame& frame () const;
+  uint64_t signature (long);
+  void compile ();
 
 private:
-  std::string formatTime (time_t) const;
-  void renderStyleDefault () const;
-  void renderStyleMono () const;
-  void renderStyleText () const;
+  // Everything visible in a frame, used to skip redundant redraws.
+  struct Snapshot
+  {
+    double fraction  {0.0};
+    int    bar       {0};
+    int    visible   {-1};
+    int    percent   {-1};
+    int    rate      {-1};    // Tenths, after scaling
+    int    scale     {0};     // Unit prefix index
+    time_t elapsed   {-1};
+    time_t estimate  {-1};
+    bool   remaining {false};
+    int64_t fastest  {-1};    // Times between updates, rounded, in ns
+    int64_t average  {-1};
+    int64_t median   {-1};
+    int64_t tail     {-1};
+
+    bool operator== (const Snapshot&) const;
+  };
+
+  typedef std::chrono::steady_clock::time_point Instant;
+
+  bool tty ();
+  void begin (Instant);
+  void sample (Instant);
+  double perSecond (double) const;
+  double remaining (double, double) const;
+  Snapshot snapshot (Instant) const;
+  void render (const Snapshot&);
+  void renderRate (const Snapshot&);
+  void renderStep (int64_t);
 
 public:
   std::string style {};
+  std::string format {};       // Template, instead of a style
   std::string label {};
   int width         {80};
   long minimum      {0};
@@ -53,9 +107,53 @@ public:
   time_t start      {0};
   bool estimate     {false};
   bool elapsed      {false};
+  bool rate         {false};
+  bool bytes        {false};
+  bool steps        {false};     // Show the times between updates
+  int fps           {0};
+  bool shown        {false};   // The terminal already shows the next frame
+  int fd            {STDOUT_FILENO};
+  int events        {-1};      // Descriptor for JSON events, or none
+  int interval      {1000};    // Milliseconds between events
+  Trace* trace      {nullptr}; // Records every update, if set
+  Metrics* metrics  {nullptr}; // Publishes the latest values, if set
 
 private:
   long _current     {-1};
+  Snapshot _shown   {};
+  bool _pending     {false};
+  Instant _drawn    {};
+
+  // Elapsed time is measured on the monotonic clock, from the first update,
+  // plus however long before that the start time was.
+  Instant _origin   {};
+  std::chrono::nanoseconds _offset {0};
+
+  // Exponentially weighted moving average of the rate, in units per second.
+  Instant _sampled  {};
+  long _sampledValue {0};
+  double _rate      {0.0};
+  bool _rated       {false};
+  int _tty          {-1};
+  Frame _frame      {};
+
+  // The steps that render a frame, and the width of everything in it but the
+  // label, the bar and the times.
+  std::vector <Format::Step> _program {};
+  int _fixed        {0};
+  int _labelAffix   {0};
+  bool _bar         {false};
+  bool _delayed     {false};
+  bool _compiled    {false};
+  Output _output    {};
+  Instant _reported {};
+  Output _log       {};
+  int _traced       {-1};      // This bar, in the trace
+  int _published    {-1};      // This bar, in the metrics
+
+  // Times between updates.
+  Histogram _intervals {};
+  Instant _stepped  {};
 };
 
 #endif
@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <State.h>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const uint32_t magic   = 0x56525354;  // 'VRST'
+static const uint32_t version = 2;
+
+////////////////////////////////////////////////////////////////////////////////
+// Opens the file, creating it if necessary.  A new file, or one that is not
+// recognized, is reset to empty.
+State::State (const std::string& file)
+{
+  auto fd = open (file.c_str (), O_RDWR | O_CREAT, 0600);
+  if (fd == -1)
+    throw std::string ("The state file '") + file + "' could not be opened: " + strerror (errno);
+
+  struct stat s;
+  if (fstat (fd, &s) == -1 ||
+      (s.st_size < (off_t) sizeof (Record) && ftruncate (fd, sizeof (Record)) == -1))
+  {
+    auto error = errno;
+    close (fd);
+    throw std::string ("The state file '") + file + "' could not be sized: " + strerror (error);
+  }
+
+  auto address = mmap (nullptr, sizeof (Record), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close (fd);
+  if (address == MAP_FAILED)
+    throw std::string ("The state file '") + file + "' could not be mapped: " + strerror (errno);
+
+  _record = static_cast <Record*> (address);
+  if (_record->magic   != magic ||
+      _record->version != version)
+    memset (_record, 0, sizeof (Record));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+State::~State ()
+{
+  if (_record)
+    munmap (_record, sizeof (Record));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool State::empty () const
+{
+  return _record->magic != magic;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long State::minimum () const
+{
+  return _record->minimum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long State::maximum () const
+{
+  return _record->maximum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+time_t State::start () const
+{
+  return _record->start;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+uint64_t State::signature () const
+{
+  return _record->signature;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Stores the range and start time.  Any recorded frame is forgotten, unless
+// they are unchanged.
+void State::range (long minimum, long maximum, time_t start)
+{
+  if (! empty ()                    &&
+      _record->minimum == minimum &&
+      _record->maximum == maximum &&
+      _record->start   == start)
+    return;
+
+  _record->magic     = magic;
+  _record->version   = version;
+  _record->minimum   = minimum;
+  _record->maximum   = maximum;
+  _record->start     = start;
+  _record->signature = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Stores the signature of the frame last drawn.
+void State::record (uint64_t signature)
+{
+  _record->signature = signature;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void State::remove (const std::string& file)
+{
+  unlink (file.c_str ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
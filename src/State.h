@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_STATE
+#define INCLUDED_STATE
+
+#include <string>
+#include <cstdint>
+#include <ctime>
+
+// A small memory-mapped file that carries the range, start time and last drawn
+// frame from one invocation to the next, so that successive invocations need
+// not repeat arguments, and can skip drawing a frame that is already shown.
+class State
+{
+public:
+  explicit State (const std::string&);
+  ~State ();
+  State (const State&) = delete;
+  State& operator= (const State&) = delete;
+
+  bool empty () const;
+  long minimum () const;
+  long maximum () const;
+  time_t start () const;
+  uint64_t signature () const;
+
+  void range (long, long, time_t);
+  void record (uint64_t);
+
+  static void remove (const std::string&);
+
+private:
+  struct Record
+  {
+    uint32_t magic;
+    uint32_t version;
+    long     minimum;
+    long     maximum;
+    time_t   start;
+    uint64_t signature;
+  };
+
+private:
+  Record* _record {nullptr};
+};
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,193 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <Trace.h>
+#include <main.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// The trace file is opened at once, so that a bad path is reported before the
+// work starts.  The binary log sits beside it, and is unlinked straight away.
+Trace::Trace (const std::string& path)
+: _path (path)
+, _origin (std::chrono::steady_clock::now ())
+{
+  _fd = open (path.c_str (), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (_fd == -1)
+    throw std::string ("The trace file '") + path + "' could not be opened: " + strerror (errno);
+
+  std::string name = path + ".XXXXXX";
+  _log = mkstemp (&name[0]);
+  if (_log == -1)
+  {
+    auto error = errno;
+    close (_fd);
+    throw std::string ("The trace log '") + name + "' could not be created: " + strerror (error);
+  }
+
+  unlink (name.c_str ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Trace::~Trace ()
+{
+  close (_log);
+  close (_fd);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Registers a bar, returning the number that its records carry.
+int Trace::bar (const std::string& name, long minimum, long maximum)
+{
+  _bars.push_back ({name.length () ? name : "progress", minimum, maximum});
+  return _bars.size () - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Trace::record (int bar, long value, bool final)
+{
+  if (_failed)
+    return;
+
+  if (_used == capacity)
+  {
+    try
+    {
+      spill ();
+    }
+
+    catch (...)
+    {
+      fputs ("Error: The trace log could not be written, so only the updates before this are traced.\n", stderr);
+      _failed = true;
+      return;
+    }
+  }
+
+  auto elapsed = std::chrono::steady_clock::now () - _origin;
+  _buffer[_used++] = {std::chrono::duration_cast <std::chrono::nanoseconds> (elapsed).count (),
+                      value,
+                      bar,
+                      final};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Converts the log.  Each bar is a track, with its value as a counter, and a
+// slice from its first update to when it was done, or its last update.  After
+// a failure, the log holds the updates up to it.
+void Trace::write ()
+{
+  if (! _failed)
+    spill ();
+
+  auto pid = (int) getpid ();
+  char event[512];
+  std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+  snprintf (event, sizeof (event),
+            "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":\"vramsteg\"}}",
+            pid);
+  out += event;
+
+  for (size_t i = 0; i < _bars.size (); ++i)
+  {
+    snprintf (event, sizeof (event),
+              ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":",
+              pid, (int) i + 1);
+    out += event + jsonString (_bars[i].name) + "}}";
+  }
+
+  // The first and last times of the slice of each bar that is still open.
+  std::vector <int64_t> begun (_bars.size (), -1);
+  std::vector <int64_t> last (_bars.size (), -1);
+  auto slice = [&] (int bar, int64_t end)
+  {
+    snprintf (event, sizeof (event),
+              ",\n{\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d,"
+              "\"args\":{\"minimum\":%ld,\"maximum\":%ld},\"name\":",
+              begun[bar] / 1000.0, (end - begun[bar]) / 1000.0, pid, bar + 1,
+              _bars[bar].minimum, _bars[bar].maximum);
+    out += event + jsonString (_bars[bar].name) + "}";
+    begun[bar] = -1;
+  };
+
+  off_t offset = 0;
+  ssize_t length;
+  while ((length = pread (_log, _buffer, sizeof (_buffer), offset)) > 0)
+  {
+    offset += length;
+    for (size_t i = 0; i < length / sizeof (Record); ++i)
+    {
+      auto& r = _buffer[i];
+      if (begun[r.bar] == -1)
+        begun[r.bar] = r.time;
+
+      last[r.bar] = r.time;
+
+      snprintf (event, sizeof (event),
+                ",\n{\"ph\":\"C\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d,\"args\":{\"value\":%lld},\"name\":",
+                r.time / 1000.0, pid, r.bar + 1, (long long) r.value);
+      out += event + jsonString (_bars[r.bar].name) + "}";
+
+      if (r.final)
+        slice (r.bar, r.time);
+    }
+
+    if (out.length () > sizeof (_buffer))
+    {
+      writeAll (_fd, out.data (), out.length ());
+      out.clear ();
+    }
+  }
+
+  if (length == -1)
+    throw std::string ("The trace log could not be read: ") + strerror (errno);
+
+  for (size_t i = 0; i < _bars.size (); ++i)
+    if (begun[i] != -1)
+      slice (i, last[i]);
+
+  out += "\n]}\n";
+  writeAll (_fd, out.data (), out.length ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Appends the buffered records to the log.
+void Trace::spill ()
+{
+  auto used = _used;
+  _used = 0;
+  if (used && ! writeAll (_log, (const char*) _buffer, used * sizeof (Record)))
+    throw std::string ("The trace log could not be written.");
+}
+
+////////////////////////////////////////////////////////////////////////////////
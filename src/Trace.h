@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_TRACE
+#define INCLUDED_TRACE
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+// Records every update of the bars in a buffer in memory, which is appended
+// to a temporary binary log in large chunks, so that recording costs little
+// more than a store.  At the end, the log is converted to Chrome trace-event
+// JSON, which Perfetto and chrome://tracing can open.  If the log cannot be
+// written, that is reported once, and recording stops, so that tracing never
+// stops the work it records.
+class Trace
+{
+public:
+  explicit Trace (const std::string&);
+  ~Trace ();
+  Trace (const Trace&) = delete;
+  Trace& operator= (const Trace&) = delete;
+
+  int bar (const std::string&, long, long);
+  void record (int, long, bool);
+  void write ();
+
+private:
+  struct Record
+  {
+    int64_t time;     // Nanoseconds since the trace began
+    int64_t value;
+    int32_t bar;
+    int32_t final;
+  };
+
+  struct Bar
+  {
+    std::string name;
+    long minimum;
+    long maximum;
+  };
+
+  void spill ();
+
+private:
+  static const int capacity = 2730;   // Records in 64KiB
+
+  std::string _path;
+  int _fd                 {-1};
+  int _log                {-1};
+  std::vector <Bar> _bars {};
+  Record _buffer[capacity];
+  int _used               {0};
+  bool _failed            {false};
+  std::chrono::steady_clock::time_point _origin;
+};
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
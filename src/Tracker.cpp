@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <Tracker.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// The Progress object belongs to the render thread from now on, until stop ().
+// It is sampled at its fps setting, or 10 times per second if that is not set.
+Tracker::Tracker (Progress& progress)
+: _progress (progress)
+, _value (progress.minimum)
+{
+  _thread = std::thread (&Tracker::run, this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Tracker::~Tracker ()
+{
+  stop ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Safe to call from any thread.
+void Tracker::advance (long amount)
+{
+  _value.fetch_add (amount, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Safe to call from any thread.
+void Tracker::set (long value)
+{
+  _value.store (value, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+long Tracker::value () const
+{
+  return _value.load (std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Draws the final value, finishes the bar and waits for the render thread.
+void Tracker::stop ()
+{
+  if (_thread.joinable ())
+  {
+    {
+      std::lock_guard <std::mutex> lock (_mutex);
+      _stopping = true;
+    }
+
+    _wake.notify_one ();
+    _thread.join ();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The sampling rate replaces the frame rate limit while the thread runs.
+void Tracker::run ()
+{
+  auto fps = _progress.fps;
+  auto period = std::chrono::nanoseconds (1000000000 / (fps > 0 ? fps : 10));
+  _progress.fps = 0;
+
+  std::unique_lock <std::mutex> lock (_mutex);
+  while (! _wake.wait_for (lock, period, [this] { return _stopping; }))
+    _progress.update (value ());
+
+  _progress.update (value ());
+  _progress.done ();
+  _progress.fps = fps;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_TRACKER
+#define INCLUDED_TRACKER
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <Progress.h>
+
+// Lets any number of threads report progress, without locks and without
+// waiting on the terminal.  Workers advance an atomic counter, and a single
+// background thread samples it at a fixed rate and draws the bar.
+class Tracker
+{
+public:
+  explicit Tracker (Progress&);
+  ~Tracker ();
+
+  void advance (long);
+  void set (long);
+  long value () const;
+  void stop ();
+
+private:
+  void run ();
+
+private:
+  Progress& _progress;
+  std::atomic <long> _value;
+  bool _stopping {false};
+  std::mutex _mutex {};
+  std::condition_variable _wake {};
+  std::thread _thread {};
+};
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
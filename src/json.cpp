@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <main.h>
+#include <cstdio>
+
+////////////////////////////////////////////////////////////////////////////////
+// A JSON string, quoted, with quotes, backslashes and control characters
+// escaped.  Everything else, including UTF-8, is copied as it is.
+std::string jsonString (const std::string& text)
+{
+  std::string quoted = "\"";
+  for (auto c : text)
+  {
+    if (c == '"' || c == '\\')
+    {
+      quoted += '\\';
+      quoted += c;
+    }
+    else if ((unsigned char) c < 0x20)
+    {
+      char escaped[8];
+      snprintf (escaped, sizeof (escaped), "\\u%04x", c);
+      quoted += escaped;
+    }
+    else
+      quoted += c;
+  }
+
+  return quoted + "\"";
+}
+
+////////////////////////////////////////////////////////////////////////////////
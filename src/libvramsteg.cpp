@@ -0,0 +1,213 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <vramsteg.h>
+#include <Progress.h>
+#include <main.h>
+#include <string>
+#include <ctime>
+#include <unistd.h>
+
+// The descriptor drawn on is either the caller's, or, when the bar must not
+// block, the terminal reopened, which the bar owns.
+struct vramsteg
+{
+  Progress progress;
+  bool automatic;
+  std::string error;
+  int fd;
+  bool nonblocking;
+  int reopened;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Errors are reported to C callers through the handle, rather than thrown.
+template <typename F>
+static int guard (vramsteg_t* bar, F action)
+{
+  if (! bar)
+    return -1;
+
+  try
+  {
+    action ();
+    bar->error.clear ();
+    return 0;
+  }
+
+  catch (const std::string& e) { bar->error = e; }
+  catch (...)                  { bar->error = "Unknown error occurred - please report."; }
+
+  return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+vramsteg_t* vramsteg_create (void)
+{
+  try
+  {
+    auto bar = new vramsteg {Progress (), true, "", STDOUT_FILENO, false, -1};
+    bar->progress.percentage = false;
+    bar->progress.remove = false;
+    bar->progress.start = time (nullptr);
+    return bar;
+  }
+
+  catch (...)
+  {
+    return nullptr;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void vramsteg_destroy (vramsteg_t* bar)
+{
+  if (bar && bar->reopened != -1)
+    close (bar->reopened);
+
+  delete bar;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Options are applied to a copy of the bar, which replaces it only once it is
+// valid, so that a rejected value leaves the bar as it was.
+int vramsteg_set (vramsteg_t* bar, enum vramsteg_option option, long value)
+{
+  return guard (bar, [&]
+  {
+    auto p           = bar->progress;
+    auto automatic   = bar->automatic;
+    auto fd          = bar->fd;
+    auto nonblocking = bar->nonblocking;
+    switch (option)
+    {
+    case VRAMSTEG_MINIMUM:    p.minimum    = value;            break;
+    case VRAMSTEG_MAXIMUM:    p.maximum    = value;            break;
+    case VRAMSTEG_WIDTH:      p.width      = value;
+                              automatic    = value == 0;       break;
+    case VRAMSTEG_START:      p.start      = value;            break;
+    case VRAMSTEG_PERCENTAGE: p.percentage = value != 0;       break;
+    case VRAMSTEG_ELAPSED:    p.elapsed    = value != 0;       break;
+    case VRAMSTEG_ESTIMATE:   p.estimate   = value != 0;       break;
+    case VRAMSTEG_REMOVE:     p.remove     = value != 0;       break;
+    case VRAMSTEG_FPS:        p.fps        = value;            break;
+    case VRAMSTEG_FD:         fd           = value;            break;
+    case VRAMSTEG_RATE:       p.rate       = value != 0;       break;
+    case VRAMSTEG_BYTES:      p.bytes      = value != 0;       break;
+    case VRAMSTEG_NONBLOCK:   nonblocking  = value != 0;       break;
+    case VRAMSTEG_EVENTS:     p.events     = value;            break;
+    case VRAMSTEG_INTERVAL:   p.interval   = value;            break;
+    case VRAMSTEG_STEPS:      p.steps      = value != 0;       break;
+    default:
+      throw std::string ("Unknown option.");
+    }
+
+    if (p.minimum > p.maximum && p.maximum != 0)
+      throw std::string ("The maximum value must not be less than the minimum value.");
+
+    if (p.fps < 0)
+      throw std::string ("The fps value must not be negative.");
+
+    if (p.interval < 0)
+      throw std::string ("The interval value must not be negative.");
+
+    // The fields shown are compiled into the steps that render a frame.
+    p.compile ();
+
+    if (option == VRAMSTEG_FD || option == VRAMSTEG_NONBLOCK)
+    {
+      p.fd = nonblocking ? terminalNonblocking (fd) : fd;
+      if (bar->reopened != -1)
+        close (bar->reopened);
+
+      bar->reopened = p.fd != fd ? p.fd : -1;
+    }
+
+    bar->progress    = p;
+    bar->automatic   = automatic;
+    bar->fd          = fd;
+    bar->nonblocking = nonblocking;
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int vramsteg_set_text (vramsteg_t* bar, enum vramsteg_text_option option, const char* value)
+{
+  return guard (bar, [&]
+  {
+    auto p = bar->progress;
+    switch (option)
+    {
+    case VRAMSTEG_STYLE:  p.style  = value ? value : ""; break;
+    case VRAMSTEG_LABEL:  p.label  = value ? value : ""; break;
+    case VRAMSTEG_FORMAT: p.format = value ? value : ""; break;
+    default:
+      throw std::string ("Unknown option.");
+    }
+
+    p.compile ();
+    bar->progress = p;
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The terminal width is determined on the first update, once the file
+// descriptor is known.
+int vramsteg_update (vramsteg_t* bar, long value)
+{
+  return guard (bar, [&]
+  {
+    // An empty range has no fraction to draw.
+    if (bar->progress.maximum <= bar->progress.minimum)
+      throw std::string ("To update the bar, its maximum must be greater than its minimum.");
+
+    if (bar->automatic)
+    {
+      bar->progress.width = terminalWidth (bar->progress.fd);
+      bar->automatic = false;
+    }
+
+    bar->progress.update (value);
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int vramsteg_done (vramsteg_t* bar)
+{
+  return guard (bar, [&]
+  {
+    bar->progress.done ();
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const char* vramsteg_error (const vramsteg_t* bar)
+{
+  return bar ? bar->error.c_str () : "No bar.";
+}
+
+////////////////////////////////////////////////////////////////////////////////
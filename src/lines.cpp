@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <main.h>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define VRAMSTEG_X86
+#include <immintrin.h>
+#endif
+
+typedef size_t (*LineCounter) (const char*, size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+static size_t countScalar (const char* data, size_t size)
+{
+  size_t count = 0;
+  for (size_t i = 0; i < size; ++i)
+    count += data[i] == '\n';
+
+  return count;
+}
+
+#ifdef VRAMSTEG_X86
+////////////////////////////////////////////////////////////////////////////////
+// Compares 16 bytes at a time.  Each match subtracts -1 from a byte counter,
+// so the counters are summed, with a sum of absolute differences, before any
+// of them can overflow, after 255 blocks.
+__attribute__ ((target ("sse2")))
+static size_t countSSE2 (const char* data, size_t size)
+{
+  const auto newline = _mm_set1_epi8 ('\n');
+  const auto zero    = _mm_setzero_si128 ();
+
+  size_t count = 0;
+  size_t i = 0;
+  while (size - i >= 16)
+  {
+    auto counters = zero;
+    auto blocks = std::min ((size - i) / 16, (size_t) 255);
+    for (size_t block = 0; block < blocks; ++block, i += 16)
+    {
+      auto bytes = _mm_loadu_si128 (reinterpret_cast <const __m128i*> (data + i));
+      counters = _mm_sub_epi8 (counters, _mm_cmpeq_epi8 (bytes, newline));
+    }
+
+    auto sums = _mm_sad_epu8 (counters, zero);
+    count += _mm_cvtsi128_si32 (sums) + _mm_extract_epi16 (sums, 4);
+  }
+
+  return count + countScalar (data + i, size - i);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The same, 32 bytes at a time.
+__attribute__ ((target ("avx2")))
+static size_t countAVX2 (const char* data, size_t size)
+{
+  const auto newline = _mm256_set1_epi8 ('\n');
+  const auto zero    = _mm256_setzero_si256 ();
+
+  size_t count = 0;
+  size_t i = 0;
+  while (size - i >= 32)
+  {
+    auto counters = zero;
+    auto blocks = std::min ((size - i) / 32, (size_t) 255);
+    for (size_t block = 0; block < blocks; ++block, i += 32)
+    {
+      auto bytes = _mm256_loadu_si256 (reinterpret_cast <const __m256i*> (data + i));
+      counters = _mm256_sub_epi8 (counters, _mm256_cmpeq_epi8 (bytes, newline));
+    }
+
+    alignas (32) uint64_t sums[4];
+    _mm256_store_si256 (reinterpret_cast <__m256i*> (sums), _mm256_sad_epu8 (counters, zero));
+    count += sums[0] + sums[1] + sums[2] + sums[3];
+  }
+
+  return count + countSSE2 (data + i, size - i);
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// The widest implementation that the processor supports.
+static LineCounter choose ()
+{
+#ifdef VRAMSTEG_X86
+  if (__builtin_cpu_supports ("avx2"))
+    return countAVX2;
+
+  if (__builtin_cpu_supports ("sse2"))
+    return countSSE2;
+#endif
+
+  return countScalar;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Counts the newlines in the data, fast enough to keep up with a pipeline
+// moving gigabytes per second.
+size_t countLines (const char* data, size_t size)
+{
+  static const LineCounter counter = choose ();
+  return counter (data, size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A particular implementation, "scalar", "sse2" or "avx2", so that each can be
+// tested, whichever the processor would choose.
+size_t countLines (const char* data, size_t size, const std::string& name)
+{
+  if (name == "scalar")
+    return countScalar (data, size);
+
+#ifdef VRAMSTEG_X86
+  if (name == "sse2" && __builtin_cpu_supports ("sse2"))
+    return countSSE2 (data, size);
+
+  if (name == "avx2" && __builtin_cpu_supports ("avx2"))
+    return countAVX2 (data, size);
+#endif
+
+  throw std::string ("The '") + name + "' line counter is not supported.";
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_MAIN
+#define INCLUDED_MAIN
+
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <csignal>
+#include <Progress.h>
+#include <Counter.h>
+#include <State.h>
+
+// run.cpp
+long runCommands (const Progress&, bool, int, const std::vector <std::string>&);
+
+// shm.cpp
+void watchCounter (Progress&, Counter&, const std::string&);
+
+// stream.cpp
+void streamValues (const Progress&, bool);
+
+// terminal.cpp
+int terminalOutput ();
+int terminalNonblocking (int);
+int terminalWidth (int);
+bool writeAll (int, const char*, size_t);
+bool changedWithin (const struct stat&, int);
+int untilNextSecond ();
+#ifdef LINUX
+int signalsQueue (sigset_t&, bool);
+void signalsRelease (int, const sigset_t&);
+#endif
+
+// json.cpp
+std::string jsonString (const std::string&);
+
+// lines.cpp
+size_t countLines (const char*, size_t);
+size_t countLines (const char*, size_t, const std::string&);
+
+// pipe.cpp
+bool pipeThrough (Progress&, bool);
+
+// proc.cpp
+int processFile (pid_t, int, long&);
+void watchProcess (Progress&, pid_t, int);
+
+// watch.cpp
+void watchFile (Progress&, const std::string&);
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,192 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <main.h>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+static const size_t chunk = 1 << 20;
+
+////////////////////////////////////////////////////////////////////////////////
+// Copies through a buffer, which is the fallback for bytes, and the only way to
+// count lines, as they must be seen.  A last line without a newline counts.
+// Returns false if the output was closed first.
+static bool copyThrough (Progress& progress, long& total, bool lines)
+{
+  static char buffer[chunk];
+  auto last = '\n';
+
+  while (true)
+  {
+    auto in = read (STDIN_FILENO, buffer, sizeof (buffer));
+    if (in == 0)
+      break;
+
+    if (in == -1)
+    {
+      if (errno == EINTR)
+        continue;
+
+      throw std::string ("Could not read input: ") + strerror (errno);
+    }
+
+    if (! writeAll (STDOUT_FILENO, buffer, in))
+      return false;
+
+    if (lines)
+    {
+      total += countLines (buffer, in);
+      last = buffer[in - 1];
+    }
+    else
+      total += in;
+
+    progress.update (total);
+  }
+
+  if (last != '\n')
+    progress.update (++total);
+
+  return true;
+}
+
+#ifdef LINUX
+////////////////////////////////////////////////////////////////////////////////
+// Moves data with splice(2) through an internal pipe, so that it is never
+// copied into user space.  Returns false if stdin or stdout does not support
+// splicing, in which case the copy must continue through a buffer.  Sets closed
+// if the output was closed first.
+static bool spliceThrough (Progress& progress, long& total, bool& closed)
+{
+  int through[2];
+  if (pipe2 (through, O_CLOEXEC) == -1)
+    return false;
+
+  // A larger pipe means fewer system calls, but is not essential.
+  fcntl (through[1], F_SETPIPE_SZ, chunk);
+
+  auto result = true;
+  while (true)
+  {
+    auto in = splice (STDIN_FILENO, nullptr, through[1], nullptr, chunk,
+                      SPLICE_F_MOVE | SPLICE_F_MORE);
+    if (in == 0)
+      break;
+
+    if (in == -1)
+    {
+      if (errno == EINTR)
+        continue;
+
+      if (errno == EINVAL || errno == ENOSYS)
+      {
+        result = false;
+        break;
+      }
+
+      throw std::string ("Could not read input: ") + strerror (errno);
+    }
+
+    while (in > 0)
+    {
+      auto out = splice (through[0], nullptr, STDOUT_FILENO, nullptr, in,
+                         SPLICE_F_MOVE | SPLICE_F_MORE);
+      if (out == -1)
+      {
+        if (errno == EINTR)
+          continue;
+
+        if (errno == EPIPE)
+        {
+          closed = true;
+          break;
+        }
+
+        if (errno != EINVAL && errno != ENOSYS)
+          throw std::string ("Could not write output: ") + strerror (errno);
+
+        // Only stdout does not support splicing, so drain the pipe the hard
+        // way, and continue without it.
+        char buffer[4096];
+        while (in > 0)
+        {
+          auto drained = read (through[0], buffer, std::min ((size_t) in, sizeof (buffer)));
+          if (drained <= 0)
+            break;
+
+          if (! writeAll (STDOUT_FILENO, buffer, drained))
+          {
+            closed = true;
+            break;
+          }
+
+          in    -= drained;
+          total += drained;
+        }
+
+        progress.update (total);
+        result = closed;
+        break;
+      }
+
+      in    -= out;
+      total += out;
+      progress.update (total);
+    }
+
+    if (in > 0 || ! result)
+      break;
+  }
+
+  close (through[0]);
+  close (through[1]);
+  return result;
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Copies stdin to stdout, updating the bar with the number of bytes or lines
+// copied.  Returns false if the output was closed before all of the input was
+// copied.
+bool pipeThrough (Progress& progress, bool lines)
+{
+  long total = 0;
+  progress.update (total);
+
+#ifdef LINUX
+  auto closed = false;
+  if (! lines && spliceThrough (progress, total, closed))
+    return ! closed;
+#endif
+
+  return copyThrough (progress, total, lines);
+}
+
+////////////////////////////////////////////////////////////////////////////////
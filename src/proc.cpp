@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <main.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef LINUX
+#include <dirent.h>
+#include <poll.h>
+#endif
+
+#ifdef LINUX
+////////////////////////////////////////////////////////////////////////////////
+// Chooses the file descriptor to follow, if none was given, as the one open on
+// the largest regular file, which for a compressor or an archiver is almost
+// always its input.  The size of the file, or zero for anything but a regular
+// file, becomes the default maximum.
+int processFile (pid_t pid, int fd, long& size)
+{
+  auto base = "/proc/" + std::to_string (pid) + "/fd/";
+  if (fd == -1)
+  {
+    auto directory = opendir (base.c_str ());
+    if (! directory)
+      throw std::string ("Process ") + std::to_string (pid) + " could not be examined: " + strerror (errno);
+
+    long largest = -1;
+    while (auto entry = readdir (directory))
+    {
+      struct stat info;
+      if (entry->d_name[0] != '.'                                 &&
+          stat ((base + entry->d_name).c_str (), &info) == 0      &&
+          S_ISREG (info.st_mode)                                  &&
+          info.st_size > largest)
+      {
+        largest = info.st_size;
+        fd = atoi (entry->d_name);
+      }
+    }
+
+    closedir (directory);
+    if (fd == -1)
+      throw std::string ("Process ") + std::to_string (pid) + " has no regular file open.";
+  }
+
+  struct stat info;
+  if (stat ((base + std::to_string (fd)).c_str (), &info) == -1)
+    throw std::string ("Process ") + std::to_string (pid) + " has no file descriptor " + std::to_string (fd) + ".";
+
+  size = S_ISREG (info.st_mode) ? (long) info.st_size : 0;
+  return fd;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Draws the position of a file descriptor in another process, as reported in
+// /proc/<pid>/fdinfo, until the process closes it or exits.  The fdinfo file
+// is opened once, and each sample is a single pread.  Samples are taken at the
+// fps setting, or 10 times per second, while the position moves, and back off
+// to once per second while it does not.  An interrupt ends the watch early.
+void watchProcess (Progress& progress, pid_t pid, int fd)
+{
+  auto name = "/proc/" + std::to_string (pid) + "/fdinfo/" + std::to_string (fd);
+  auto info = open (name.c_str (), O_RDONLY | O_CLOEXEC);
+  if (info == -1)
+    throw std::string ("Process ") + std::to_string (pid) + " could not be examined: " + strerror (errno);
+
+  // The position is on the first line, as "pos:\t<offset>".
+  auto position = [info] ()
+  {
+    char buffer[128];
+    auto length = pread (info, buffer, sizeof (buffer) - 1, 0);
+    if (length <= 0)
+      return -1L;
+
+    buffer[length] = '\0';
+    auto pos = strstr (buffer, "pos:");
+    return pos ? atol (pos + 4) : -1L;
+  };
+
+  sigset_t blocked;
+  auto signals_fd = signalsQueue (blocked, false);
+
+  auto fastest = progress.fps > 0 ? std::max (1, 1000 / progress.fps) : 100;
+  auto slowest = std::max (fastest, 1000);
+  auto period  = fastest;
+  progress.fps = 0;
+
+  auto last = position ();
+  while (last != -1)
+  {
+    progress.update (last);
+
+    struct pollfd ready {signals_fd, POLLIN, 0};
+    if (poll (&ready, 1, period) > 0)
+      break;
+
+    auto next = position ();
+    period = next == last ? std::min (period * 2, slowest) : fastest;
+    last = next;
+  }
+
+  signalsRelease (signals_fd, blocked);
+  close (info);
+
+  progress.done ();
+}
+
+#else
+////////////////////////////////////////////////////////////////////////////////
+int processFile (pid_t, int, long&)
+{
+  throw std::string ("The --pid feature needs /proc/<pid>/fdinfo, which this system lacks.");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void watchProcess (Progress&, pid_t, int)
+{
+  throw std::string ("The --pid feature needs /proc/<pid>/fdinfo, which this system lacks.");
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,374 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <main.h>
+#include <Board.h>
+#include <algorithm>
+#include <deque>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+extern char** environ;
+
+// A worker slot runs one command at a time.  Its output, stdout and stderr
+// together, comes through a pipe.  A command is complete once it has exited
+// and its output has ended, which may happen in either order.
+struct Worker
+{
+  bool busy        {false};
+  pid_t pid        {0};
+  int output       {-1};
+  int status       {0};
+  std::string partial {};
+};
+
+// Signals are turned into bytes on a pipe, so that they wake poll.
+static int wakeup[2] {-1, -1};
+
+////////////////////////////////////////////////////////////////////////////////
+static void notice (int signo)
+{
+  auto error = errno;
+  char byte = (char) signo;
+  // A full pipe already holds a wakeup.
+  auto ignored = write (wakeup[1], &byte, 1);
+  (void) ignored;
+
+  errno = error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Each {} in the command is replaced by the item, or if there is none, the
+// item is added as the last argument, as xargs does.
+static std::vector <std::string> expand (const std::vector <std::string>& command, const std::string& item)
+{
+  std::vector <std::string> args;
+  auto found = false;
+  for (auto arg : command)
+  {
+    std::string::size_type at = 0;
+    while ((at = arg.find ("{}", at)) != std::string::npos)
+    {
+      arg.replace (at, 2, item);
+      at += item.length ();
+      found = true;
+    }
+
+    args.push_back (arg);
+  }
+
+  if (! found)
+    args.push_back (item);
+
+  return args;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Starts a command with stdin from /dev/null, and stdout and stderr on a pipe.
+// vramsteg ignores or blocks signals that the command should not, so they are
+// restored to their defaults.  Returns 0 on success, or an errno value.
+static int launch (const std::vector <std::string>& args, Worker& worker)
+{
+  int ends[2];
+  if (pipe2 (ends, O_CLOEXEC) == -1)
+    return errno;
+
+  std::vector <char*> argv;
+  for (auto& arg : args)
+    argv.push_back (const_cast <char*> (arg.c_str ()));
+  argv.push_back (nullptr);
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init (&actions);
+  posix_spawn_file_actions_addopen (&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+  posix_spawn_file_actions_adddup2 (&actions, ends[1], STDOUT_FILENO);
+  posix_spawn_file_actions_adddup2 (&actions, ends[1], STDERR_FILENO);
+
+  sigset_t defaults;
+  sigset_t none;
+  sigfillset (&defaults);
+  sigemptyset (&none);
+  posix_spawnattr_t attributes;
+  posix_spawnattr_init (&attributes);
+  posix_spawnattr_setsigdefault (&attributes, &defaults);
+  posix_spawnattr_setsigmask (&attributes, &none);
+  posix_spawnattr_setflags (&attributes, POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK);
+
+  auto error = posix_spawnp (&worker.pid, argv[0], &actions, &attributes, argv.data (), environ);
+
+  posix_spawnattr_destroy (&attributes);
+  posix_spawn_file_actions_destroy (&actions);
+  close (ends[1]);
+
+  if (error)
+  {
+    close (ends[0]);
+    worker.pid = 0;
+    return error;
+  }
+
+  worker.busy   = true;
+  worker.output = ends[0];
+  worker.partial.clear ();
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reads work items from stdin, one per line, and runs the command for each in
+// one of a fixed number of worker slots.  The bar counts completed commands,
+// and each busy slot has a status line showing its command.  Output from the
+// commands is written above the bar, a line at a time.  An interrupt is passed
+// on to the running commands, and no more are started.  Returns the number of
+// commands that failed.
+long runCommands (const Progress& prototype, bool resizable, int jobs,
+                  const std::vector <std::string>& command)
+{
+  if (pipe2 (wakeup, O_NONBLOCK | O_CLOEXEC) == -1)
+    throw std::string ("Could not run commands: ") + strerror (errno);
+
+  struct sigaction action {};
+  action.sa_handler = notice;
+  action.sa_flags   = SA_RESTART;
+  sigemptyset (&action.sa_mask);
+
+  struct sigaction previous[4];
+  const int handled[4] {SIGCHLD, SIGINT, SIGTERM, SIGWINCH};
+  for (int i = 0; i < 4; ++i)
+    sigaction (handled[i], &action, &previous[i]);
+
+  Board board (prototype);
+  std::vector <Worker> workers (jobs);
+  std::deque <std::string> items;
+  std::string partial;
+  auto reading   = true;
+  auto stopping  = false;
+  long completed = 0;
+  long failed    = 0;
+  auto ticking   = prototype.elapsed || prototype.estimate || prototype.rate;
+  auto slot      = [] (int i) { return "#" + std::to_string (i + 1); };
+
+  board.update ("", prototype.minimum);
+
+  char buffer[65536];
+  while (true)
+  {
+    // Idle slots take the next items, and once there are none left, their
+    // status lines go.
+    for (int i = 0; i < jobs; ++i)
+    {
+      auto& worker = workers[i];
+      if (worker.busy)
+        continue;
+
+      if (items.empty () || stopping)
+      {
+        if (! reading || stopping)
+          board.finish (slot (i));
+
+        continue;
+      }
+
+      auto args = expand (command, items.front ());
+      items.pop_front ();
+
+      std::string line = "[" + std::to_string (i + 1) + "]";
+      for (auto& arg : args)
+        line += " " + arg;
+
+      board.status (slot (i), line);
+      auto error = launch (args, worker);
+      if (error)
+      {
+        board.print ("Could not run '" + args[0] + "': " + strerror (error) + "\n");
+        ++failed;
+        board.update ("", prototype.minimum + ++completed);
+      }
+    }
+
+    auto running = std::count_if (workers.begin (), workers.end (), [] (const Worker& w) { return w.busy; });
+    if (running == 0 && (stopping || (! reading && items.empty ())))
+      break;
+
+    board.write ();
+
+    // Input is only read while there are slots for it, so that a long list of
+    // items is not held in memory.
+    std::vector <struct pollfd> fds {{wakeup[0], POLLIN, 0}};
+    if (reading && ! stopping && items.size () < (size_t) jobs)
+      fds.push_back ({STDIN_FILENO, POLLIN, 0});
+
+    for (auto& worker : workers)
+      if (worker.output != -1)
+        fds.push_back ({worker.output, POLLIN, 0});
+
+    if (board.congested ())
+      fds.push_back ({prototype.fd, POLLOUT, 0});
+
+    auto timeout = ticking ? untilNextSecond () : -1;
+    if (board.pending () && prototype.fps > 0)
+    {
+      auto owed = std::max (1, 1000 / prototype.fps);
+      timeout = timeout == -1 ? owed : std::min (timeout, owed);
+    }
+
+    auto count = poll (fds.data (), fds.size (), timeout);
+    if (count == -1 && errno != EINTR)
+      throw std::string ("Could not run commands: ") + strerror (errno);
+
+    if (count == 0)
+      board.tick ();
+
+    for (auto& ready : fds)
+    {
+      if (! ready.revents)
+        continue;
+
+      if (ready.fd == wakeup[0])
+      {
+        char signals[64];
+        ssize_t length;
+        while ((length = read (wakeup[0], signals, sizeof (signals))) > 0)
+        {
+          for (ssize_t i = 0; i < length; ++i)
+          {
+            if (signals[i] == SIGWINCH)
+            {
+              if (resizable)
+                board.resize (terminalWidth (prototype.fd));
+            }
+            else if (signals[i] != SIGCHLD && ! stopping)
+            {
+              stopping = true;
+              items.clear ();
+              for (auto& worker : workers)
+                if (worker.pid)
+                  kill (worker.pid, signals[i]);
+            }
+          }
+        }
+
+        pid_t pid;
+        int status;
+        while ((pid = waitpid (-1, &status, WNOHANG)) > 0)
+          for (auto& worker : workers)
+            if (worker.pid == pid)
+            {
+              worker.pid    = 0;
+              worker.status = status;
+            }
+      }
+
+      else if (ready.fd == STDIN_FILENO)
+      {
+        auto length = read (STDIN_FILENO, buffer, sizeof (buffer));
+        if (length > 0)
+        {
+          partial.append (buffer, length);
+          std::string::size_type start = 0;
+          std::string::size_type end;
+          while ((end = partial.find ('\n', start)) != std::string::npos)
+          {
+            if (end > start)
+              items.push_back (partial.substr (start, end - start));
+
+            start = end + 1;
+          }
+
+          partial.erase (0, start);
+        }
+        else if (length == 0 || errno != EINTR)
+        {
+          reading = false;
+          if (partial.length ())
+            items.push_back (partial);
+        }
+      }
+
+      else if (ready.fd == prototype.fd)
+        board.tick ();
+
+      else
+      {
+        for (auto& worker : workers)
+        {
+          if (worker.output != ready.fd)
+            continue;
+
+          // Only whole lines are written, unless the output ends without one.
+          auto length = read (worker.output, buffer, sizeof (buffer));
+          if (length > 0)
+          {
+            worker.partial.append (buffer, length);
+            auto last = worker.partial.rfind ('\n');
+            if (last != std::string::npos)
+            {
+              board.print (worker.partial.substr (0, last + 1));
+              worker.partial.erase (0, last + 1);
+            }
+          }
+          else if (length == 0 || errno != EINTR)
+          {
+            board.print (worker.partial);
+            close (worker.output);
+            worker.output = -1;
+          }
+        }
+      }
+    }
+
+    // A command is complete once it has exited and its output has ended.
+    for (auto& worker : workers)
+    {
+      if (worker.busy && worker.pid == 0 && worker.output == -1)
+      {
+        worker.busy = false;
+        if (! WIFEXITED (worker.status) || WEXITSTATUS (worker.status) != 0)
+          ++failed;
+
+        board.update ("", prototype.minimum + ++completed);
+      }
+    }
+  }
+
+  board.done ();
+
+  for (int i = 0; i < 4; ++i)
+    sigaction (handled[i], &previous[i], nullptr);
+
+  close (wakeup[0]);
+  close (wakeup[1]);
+  return failed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
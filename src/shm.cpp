@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <main.h>
+#include <chrono>
+#include <thread>
+#ifdef LINUX
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Draws a shared counter, sampled at the fps setting, or 10 times per second,
+// until it reaches the maximum, and then removes it.  An interrupt ends the
+// display early, and leaves the counter to its producers.
+void watchCounter (Progress& progress, Counter& counter, const std::string& name)
+{
+  auto period = std::chrono::nanoseconds (1000000000 / (progress.fps > 0 ? progress.fps : 10));
+  progress.fps = 0;
+
+#ifdef LINUX
+  // Waiting for an interrupt is the pause between samples.
+  sigset_t blocked;
+  auto signals_fd = signalsQueue (blocked, false);
+  auto timeout = (int) std::chrono::duration_cast <std::chrono::milliseconds> (period).count ();
+#endif
+
+  auto finished = false;
+  while (true)
+  {
+    auto value = counter.value ();
+    progress.update (value);
+    if (value >= counter.maximum ())
+    {
+      finished = true;
+      break;
+    }
+
+#ifdef LINUX
+    struct pollfd ready {signals_fd, POLLIN, 0};
+    if (poll (&ready, 1, timeout) > 0)
+      break;
+#else
+    std::this_thread::sleep_for (period);
+#endif
+  }
+
+#ifdef LINUX
+  signalsRelease (signals_fd, blocked);
+#endif
+
+  progress.done ();
+  if (finished)
+    Counter::unlink (name);
+}
+
+////////////////////////////////////////////////////////////////////////////////
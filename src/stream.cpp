@@ -0,0 +1,361 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <main.h>
+#include <Board.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#ifdef LINUX
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#endif
+
+// A bar's newest value, gathered from a batch of input.
+struct Pending
+{
+  std::string name;
+  long        value;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+static bool blank (char c)
+{
+  return c == ' ' || c == '\t';
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The value must be all there is between begin and end, which is followed by a
+// character that is not a digit.
+static long parseValue (const char* begin, const char* end)
+{
+  char* stop;
+  errno = 0;
+  auto value = strtol (begin, &stop, 10);
+  if (begin == end || stop != end || errno == ERANGE)
+    throw std::string ("The value '") + std::string (begin, end) + "' is not an integer.";
+
+  return value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static Pending& pending (const Board& board, std::vector <Pending>& batch, const char* name, size_t length)
+{
+  for (auto& entry : batch)
+    if (entry.name.length () == length && ! entry.name.compare (0, length, name, length))
+      return entry;
+
+  std::string key (name, length);
+  batch.push_back ({key, board.value (key)});
+  return batch.back ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Applies one line of input to the batch.  A line is either a value for the
+// bar, or a name and a value for one of several bars, each drawn on its own
+// line.  A value with a leading '+' is added to the current value.  A name
+// followed by 'done' finishes that bar.
+//
+//   42
+//   +5
+//   shard3 4512
+//   shard3 +100
+//   shard3 done
+//
+static void streamLine (Board& board, std::vector <Pending>& batch, const char* begin, const char* end)
+{
+  while (end > begin && blank (end[-1]))
+    --end;
+
+  if (end == begin)
+    return;
+
+  auto token = end;
+  while (token > begin && ! blank (token[-1]))
+    --token;
+
+  auto name = token;
+  while (name > begin && blank (name[-1]))
+    --name;
+
+  auto length = (size_t) (name - begin);
+  if (end - token == 4 && ! strncmp (token, "done", 4))
+  {
+    // Values before 'done' are drawn first, in order, as the bar may be
+    // removed.
+    for (auto& entry : batch)
+      board.update (entry.name, entry.value);
+
+    batch.clear ();
+    board.finish (std::string (begin, length));
+  }
+  else if (*token == '+')
+    pending (board, batch, begin, length).value += parseValue (token, end);
+  else
+    pending (board, batch, begin, length).value = parseValue (token, end);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Draws the newest value of every bar in the batch, with a single write.
+static void streamApply (Board& board, std::vector <Pending>& batch)
+{
+  for (auto& entry : batch)
+    board.update (entry.name, entry.value);
+
+  batch.clear ();
+  board.write ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Gathers every complete line in a chunk of input into the batch.  The
+// remainder of a line is kept until the rest of it arrives.
+static void streamChunk (Board& board, std::vector <Pending>& batch, std::string& partial, const char* data, size_t size)
+{
+  auto end = data + size;
+  while (data < end)
+  {
+    auto newline = static_cast <const char*> (memchr (data, '\n', end - data));
+    if (! newline)
+    {
+      partial.append (data, end - data);
+      return;
+    }
+
+    if (partial.length ())
+    {
+      partial.append (data, newline - data);
+      streamLine (board, batch, partial.data (), partial.data () + partial.length ());
+      partial.clear ();
+    }
+    else
+      streamLine (board, batch, data, newline);
+
+    data = newline + 1;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reads whatever input is available, up to a limit, and draws only the newest
+// values, so that a producer that is faster than the terminal costs one frame
+// per batch instead of one per line.  Returns false on an error.
+static bool streamRead (Board& board, std::string& partial, bool& finished)
+{
+  static char buffer[65536];
+  std::vector <Pending> batch;
+
+  for (int chunks = 0; chunks < 16; ++chunks)
+  {
+    auto in = read (STDIN_FILENO, buffer, sizeof (buffer));
+    if (in > 0)
+      streamChunk (board, batch, partial, buffer, in);
+    else if (in == 0)
+      finished = true;
+    else if (errno != EINTR && errno != EAGAIN)
+      return false;
+
+    int available = 0;
+    if (in <= 0 || ioctl (STDIN_FILENO, FIONREAD, &available) == -1 || available <= 0)
+      break;
+  }
+
+  // A final line without a newline still counts.
+  if (finished && partial.length ())
+  {
+    streamLine (board, batch, partial.data (), partial.data () + partial.length ());
+    partial.clear ();
+  }
+
+  streamApply (board, batch);
+  return true;
+}
+
+#ifdef LINUX
+////////////////////////////////////////////////////////////////////////////////
+// Waits on stdin, signals and a timer together, so that the bar keeps time and
+// follows the terminal width while no input arrives, yet sleeps in between.
+// The timer ticks just after each whole second, when the elapsed and estimated
+// times change, and only runs if they, or the rate, are shown.  A frame held
+// back by throttling is drawn when its time comes, by the epoll timeout.  While
+// the terminal is too slow to take the output, it is watched, and the bars are
+// brought up to date as soon as it can take more.
+// Returns false if stdin cannot be polled, as for a regular file.
+static bool streamEvents (Board& board, const Progress& prototype, bool resizable)
+{
+  auto events = epoll_create1 (EPOLL_CLOEXEC);
+  if (events == -1)
+    return false;
+
+  struct epoll_event event {};
+  event.events  = EPOLLIN;
+  event.data.fd = STDIN_FILENO;
+  if (epoll_ctl (events, EPOLL_CTL_ADD, STDIN_FILENO, &event) == -1)
+  {
+    close (events);
+    return false;
+  }
+
+  // An interrupt ends the stream as if the input had ended, which leaves the
+  // terminal tidy.
+  sigset_t blocked;
+  auto signals_fd = signalsQueue (blocked, true);
+  event.data.fd = signals_fd;
+  epoll_ctl (events, EPOLL_CTL_ADD, signals_fd, &event);
+
+  auto timer = -1;
+  if (prototype.elapsed || prototype.estimate || prototype.rate)
+  {
+    timer = timerfd_create (CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+
+    struct itimerspec tick {};
+    clock_gettime (CLOCK_REALTIME, &tick.it_value);
+    tick.it_value.tv_sec    += 1;
+    tick.it_value.tv_nsec    = 10000000;
+    tick.it_interval.tv_sec  = 1;
+    timerfd_settime (timer, TFD_TIMER_ABSTIME, &tick, nullptr);
+
+    event.data.fd = timer;
+    epoll_ctl (events, EPOLL_CTL_ADD, timer, &event);
+  }
+
+  // Everything is released however the loop ends, as a bad line throws.
+  auto release = [&] ()
+  {
+    if (timer != -1)
+      close (timer);
+
+    close (events);
+    signalsRelease (signals_fd, blocked);
+  };
+
+  std::string partial;
+  auto finished = false;
+  auto failed   = false;
+  auto watching = false;
+  try
+  {
+    while (! finished && ! failed)
+    {
+      if (board.congested () != watching)
+      {
+        watching      = ! watching;
+        event.events  = EPOLLOUT;
+        event.data.fd = prototype.fd;
+        epoll_ctl (events, watching ? EPOLL_CTL_ADD : EPOLL_CTL_DEL, prototype.fd, &event);
+      }
+
+      auto timeout = board.pending () && prototype.fps > 0 && ! watching
+                   ? std::max (1, 1000 / prototype.fps)
+                   : -1;
+
+      struct epoll_event ready[4];
+      auto count = epoll_wait (events, ready, 4, timeout);
+      if (count == -1 && errno != EINTR)
+        failed = true;
+
+      if (count == 0)
+        board.tick ();
+
+      for (int i = 0; i < count; ++i)
+      {
+        auto fd = ready[i].data.fd;
+        if (fd == STDIN_FILENO)
+          failed = ! streamRead (board, partial, finished);
+
+        else if (fd == signals_fd)
+        {
+          struct signalfd_siginfo info;
+          while (read (signals_fd, &info, sizeof (info)) == sizeof (info))
+          {
+            if (info.ssi_signo != SIGWINCH)
+              finished = true;
+            else if (resizable)
+              board.resize (terminalWidth (prototype.fd));
+          }
+        }
+
+        else if (fd == timer)
+        {
+          uint64_t expirations;
+          if (read (timer, &expirations, sizeof (expirations)) > 0)
+            board.tick ();
+        }
+
+        else if (fd == prototype.fd)
+          board.tick ();
+      }
+    }
+  }
+
+  catch (...)
+  {
+    release ();
+    throw;
+  }
+
+  auto error = errno;
+  release ();
+
+  if (failed)
+    throw std::string ("Could not read input: ") + strerror (error);
+
+  return true;
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// Reads one update per line from stdin, until the end of input.  When the
+// width is not fixed, the bars follow the width of the terminal.
+void streamValues (const Progress& prototype, bool resizable)
+{
+  Board board (prototype);
+
+#ifdef LINUX
+  if (streamEvents (board, prototype, resizable))
+  {
+    board.done ();
+    return;
+  }
+#endif
+
+  // Without an event loop, input is read as it comes.
+  std::string partial;
+  auto finished = false;
+  while (! finished)
+    if (! streamRead (board, partial, finished))
+      throw std::string ("Could not read input: ") + strerror (errno);
+
+  board.done ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <main.h>
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#ifdef LINUX
+#include <sys/signalfd.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// When stdout carries data, the bar is drawn on the controlling terminal, or
+// failing that, on stderr.
+int terminalOutput ()
+{
+  auto fd = open ("/dev/tty", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+  return fd != -1 ? fd : STDERR_FILENO;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A terminal descriptor that never blocks, so that a long-lived bar can drop
+// frames that a slow terminal is not ready for.  The terminal is opened again,
+// because the file status flags of an inherited descriptor are shared with the
+// shell and every other process that writes to it.  A pipe, such as one that
+// carries events to a slow reader, is opened again in the same way.  Anything
+// else is used as it is.
+int terminalNonblocking (int fd)
+{
+  if (fcntl (fd, F_GETFL) & O_NONBLOCK)
+    return fd;
+
+  std::string name;
+  struct stat info;
+  if (isatty (fd))
+  {
+    auto terminal = ttyname (fd);
+    if (! terminal)
+      return fd;
+
+    name = terminal;
+  }
+  else if (fstat (fd, &info) == 0 && S_ISFIFO (info.st_mode))
+    name = "/proc/self/fd/" + std::to_string (fd);
+  else
+    return fd;
+
+  auto reopened = open (name.c_str (), O_WRONLY | O_NONBLOCK | O_NOCTTY | O_CLOEXEC);
+  return reopened != -1 ? reopened : fd;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Dynamically determine terminal width, defaulting to 80.
+int terminalWidth (int fd)
+{
+  struct winsize size;
+  if (ioctl (fd, TIOCGWINSZ, &size) != -1 && size.ws_col)
+    return size.ws_col;
+
+  return 80;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writes everything, or returns false if the reader has gone away.
+bool writeAll (int fd, const char* data, size_t length)
+{
+  while (length)
+  {
+    auto written = write (fd, data, length);
+    if (written == -1)
+    {
+      if (errno == EINTR)
+        continue;
+
+      if (errno == EPIPE)
+        return false;
+
+      throw std::string ("Could not write output: ") + strerror (errno);
+    }
+
+    data   += written;
+    length -= written;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Whether a file was last changed less than the given time ago, which lets
+// successive invocations share an interval between writes to it.
+bool changedWithin (const struct stat& info, int milliseconds)
+{
+  struct timespec now;
+  clock_gettime (CLOCK_REALTIME, &now);
+  return (now.tv_sec  - info.st_mtim.tv_sec)  * 1000 +
+         (now.tv_nsec - info.st_mtim.tv_nsec) / 1000000 < milliseconds;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Milliseconds until just after the next whole second, when the elapsed and
+// estimated times change.
+int untilNextSecond ()
+{
+  struct timespec now;
+  clock_gettime (CLOCK_REALTIME, &now);
+  return 1010 - (int) (now.tv_nsec / 1000000);
+}
+
+#ifdef LINUX
+////////////////////////////////////////////////////////////////////////////////
+// Interrupts, and resizes if asked for, are blocked and queued for the
+// returned signalfd, so that an event loop waits for them with its input.
+// Blocked signals are only queued if they are not ignored, so interrupts get
+// their default action back meanwhile.  The previous mask is kept in saved.
+int signalsQueue (sigset_t& saved, bool resizes)
+{
+  sigset_t signals;
+  sigemptyset (&signals);
+  if (resizes)
+    sigaddset (&signals, SIGWINCH);
+  sigaddset (&signals, SIGINT);
+  sigaddset (&signals, SIGTERM);
+  sigprocmask (SIG_BLOCK, &signals, &saved);
+  signal (SIGINT,  SIG_DFL);
+  signal (SIGTERM, SIG_DFL);
+
+  return signalfd (-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Undoes signalsQueue, leaving interrupts ignored while the bar is drawn.
+void signalsRelease (int fd, const sigset_t& saved)
+{
+  close (fd);
+  signal (SIGINT,  SIG_IGN);
+  signal (SIGTERM, SIG_IGN);
+  sigprocmask (SIG_SETMASK, &saved, nullptr);
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
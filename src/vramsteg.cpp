@@ -24,15 +24,23 @@
 //
 ////////////////////////////////////////////////////////////////////////////////
 
-#include <iostream>
-#include <sys/ioctl.h>
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <cerrno>
 #include <getopt.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <ctime>
 #include <csignal>
+#include <string>
+#include <vector>
+#include <memory>
 #include <Progress.h>
+#include <Trace.h>
+#include <Metrics.h>
+#include <main.h>
 #include <cmake.h>
 
 extern char *optarg;
@@ -44,29 +52,51 @@ extern int optreset;
 ////////////////////////////////////////////////////////////////////////////////
 void showUsage ()
 {
-  std::cout << "\n"
-            << "Usage: vramsteg [options]\n"
-            << "\n"
-            << "  -y, --style <name>          Style of bar rendering\n"
-            << "  -l, --label <value>         Progress bar label\n"
-            << "  -m, --min <value>           Equivalent to 0%\n"
-            << "  -x, --max <value>           Equivalent to 100%\n"
-            << "  -c, --current <value>       Current value of progress bar\n"
-            << "  -p, --percentage            Show percentage\n"
-            << "  -s, --start <value>         Start time epoch\n"
-            << "  -w, --width <value>         Width of progress bar, default full width\n"
-            << "  -n, --now                   Returns current time as epoch\n"
-            << "  -r, --remove                Removes the progress bar\n"
-            << "  -e, --elapsed               Show elapsed time (needs --start)\n"
-            << "  -t, --estimate              Show estimated remaining time (needs --start)\n"
-            << "  -v, --version               Show vramsteg version\n"
-            << "  -h, --help                  Show command options\n"
-            << "\n"
-            << "Supported styles are:\n"
-            << "  (default)     label \033[42m        \033[41m            \033[0m 40%\n"
-            << "  mono          label \033[47m    \033[40m                \033[0m 20%\n"
-            << "  text          label [************      ] 60%\n"
-            << "\n";
+  fputs ("\n"
+         "Usage: vramsteg [options]\n"
+         "       vramsteg run [options] -- <command> [{}]\n"
+         "\n"
+         "  -y, --style <name>          Style of bar rendering\n"
+         "      --format <template>     Layout of the bar, such as '{label }[{bar:#-}]{ pct}'\n"
+         "  -l, --label <value>         Progress bar label\n"
+         "  -m, --min <value>           Equivalent to 0%\n"
+         "  -x, --max <value>           Equivalent to 100%\n"
+         "  -c, --current <value>       Current value of progress bar\n"
+         "  -p, --percentage            Show percentage\n"
+         "  -s, --start <value>         Start time epoch\n"
+         "  -w, --width <value>         Width of progress bar, default full width\n"
+         "  -n, --now                   Returns current time as epoch\n"
+         "  -r, --remove                Removes the progress bar\n"
+         "  -e, --elapsed               Show elapsed time (needs --start)\n"
+         "  -t, --estimate              Show estimated remaining time (needs --start)\n"
+         "      --rate                  Show the rate of progress, per second\n"
+         "      --bytes                 Show the rate in bytes, with binary units\n"
+         "      --steps                 Show the min/avg/p50/p99 time between updates\n"
+         "      --stream                Read successive current values from stdin\n"
+         "      --fps <value>           Maximum redraws per second, default unlimited\n"
+         "      --pipe                  Copy stdin to stdout, counting bytes\n"
+         "      --lines                 Copy stdin to stdout, counting lines\n"
+         "      --shm <name>            Draw a shared counter, until it reaches --max\n"
+         "      --init                  Create the --shm counter (needs --max)\n"
+         "      --add <value>           Add to the --shm counter, without drawing\n"
+         "      --watch-file <path>     Draw the size of a file, until it reaches --max\n"
+         "      --pid <pid>             Draw how far a process has read its largest file\n"
+         "      --fd <value>            Follow this file descriptor of the --pid process\n"
+         "      --state <file>          Remember arguments and the last frame drawn\n"
+         "      --events <file>         Append JSON progress events, '-' for stdout\n"
+         "      --interval <seconds>    Minimum time between events or metrics, default 1\n"
+         "      --trace <file>          Write every update as Chrome trace JSON, at the end\n"
+         "      --metrics-file <path>   Keep Prometheus gauges in a file, once per interval\n"
+         "  -j, --jobs <value>          Commands run at once by 'run', default all cores\n"
+         "  -v, --version               Show vramsteg version\n"
+         "  -h, --help                  Show command options\n"
+         "\n"
+         "Supported styles are:\n"
+         "  (default)     label \033[42m        \033[41m            \033[0m 40%\n"
+         "  mono          label \033[47m    \033[40m                \033[0m 20%\n"
+         "  text          label [************      ] 60%\n"
+         "\n",
+         stdout);
 
   exit (0);
 }
@@ -74,17 +104,18 @@ void showUsage ()
 ////////////////////////////////////////////////////////////////////////////////
 void showVersion ()
 {
-  std::cout << "\n"
-            << "\033[1m" << PACKAGE_STRING << "\033[0m\n"
-            << "Copyright (C) 2010 - 2017, Göteborg Bit Factory\n"
-            << "Copyright (C) 2010 - 2017, P. Beckingham, F. Hernandez.\n"
-            << "\n"
-            << "Vramsteg may be copied only under the terms of the MIT license, "
-            << "which may be found in the taskwarrior source kit.\n"
-            << "\n"
-            << "Documentation for vramsteg can be found using 'man vramsteg', or "
-            << "at http://tasktools.org.\n"
-            << "\n";
+  fputs ("\n"
+         "\033[1m" PACKAGE_STRING "\033[0m\n"
+         "Copyright (C) 2010 - 2017, Göteborg Bit Factory\n"
+         "Copyright (C) 2010 - 2017, P. Beckingham, F. Hernandez.\n"
+         "\n"
+         "Vramsteg may be copied only under the terms of the MIT license, "
+         "which may be found in the taskwarrior source kit.\n"
+         "\n"
+         "Documentation for vramsteg can be found using 'man vramsteg', or "
+         "at http://tasktools.org.\n"
+         "\n",
+         stdout);
 
   exit (0);
 }
@@ -106,19 +137,36 @@ int main (int argc, char** argv)
     long        arg_current    {0};
     bool        arg_elapsed    {false};
     bool        arg_estimate   {false};
+    bool        arg_rate       {false};
+    bool        arg_bytes      {false};
+    bool        arg_steps      {false};
     std::string arg_label      {};
     long        arg_max        {0};
     long        arg_min        {0};
     bool        arg_percentage {false};
     bool        arg_remove     {false};
     time_t      arg_start      {0};
-    int         arg_width      {80};
+    int         arg_width      {0};
     std::string arg_style      {};
-
-    // Dynamically determine terminal width.
-    unsigned short buff[4];
-    if (ioctl (fileno(stdout), TIOCGWINSZ, &buff) != -1)
-      arg_width = buff[1];
+    std::string arg_format     {};
+    bool        arg_stream     {false};
+    int         arg_fps        {0};
+    bool        arg_pipe       {false};
+    bool        arg_lines      {false};
+    std::string arg_shm        {};
+    bool        arg_init       {false};
+    bool        arg_adding     {false};
+    long        arg_add        {0};
+    std::string arg_state      {};
+    std::string arg_events     {};
+    std::string arg_trace      {};
+    std::string arg_metrics    {};
+    std::string arg_watch      {};
+    pid_t       arg_pid        {0};
+    int         arg_fd         {-1};
+    double      arg_interval   {1.0};
+    int         arg_jobs       {0};
+    std::vector <std::string> arg_command {};
 
     static struct option longopts[] = {
       { "current",    required_argument, nullptr, 'c' },
@@ -134,12 +182,41 @@ int main (int argc, char** argv)
       { "version",    no_argument,       nullptr, 'v' },
       { "width",      required_argument, nullptr, 'w' },
       { "style",      required_argument, nullptr, 'y' },
+      { "format",     required_argument, nullptr, 'Y' },
       { "help",       no_argument,       nullptr, 'h' },
+      { "rate",       no_argument,       nullptr, 'R' },
+      { "bytes",      no_argument,       nullptr, 'B' },
+      { "steps",      no_argument,       nullptr, 'Q' },
+      { "stream",     no_argument,       nullptr, 'S' },
+      { "fps",        required_argument, nullptr, 'F' },
+      { "pipe",       no_argument,       nullptr, 'P' },
+      { "lines",      no_argument,       nullptr, 'L' },
+      { "shm",        required_argument, nullptr, 'H' },
+      { "init",       no_argument,       nullptr, 'I' },
+      { "add",        required_argument, nullptr, 'A' },
+      { "state",      required_argument, nullptr, 'T' },
+      { "events",     required_argument, nullptr, 'E' },
+      { "interval",   required_argument, nullptr, 'N' },
+      { "watch-file", required_argument, nullptr, 'W' },
+      { "pid",        required_argument, nullptr, 'D' },
+      { "fd",         required_argument, nullptr, 'O' },
+      { "jobs",       required_argument, nullptr, 'j' },
+      { "trace",      required_argument, nullptr, 'K' },
+      { "metrics-file", required_argument, nullptr, 'U' },
       { nullptr,      0,                 nullptr, 0   }
     };
 
+    // The run command takes options up to the command it runs, which keeps its
+    // own.
+    auto running = argc > 1 && ! strcmp (argv[1], "run");
+    if (running)
+    {
+      --argc;
+      ++argv;
+    }
+
     int ch;
-    while ((ch = getopt_long (argc, argv, "c:etl:x:m:nprs:vw:h", longopts, nullptr)) != -1)
+    while ((ch = getopt_long (argc, argv, running ? "+c:etl:x:m:nprs:vw:hj:" : "c:etl:x:m:nprs:vw:h", longopts, nullptr)) != -1)
     {
       switch (ch)
       {
@@ -149,17 +226,39 @@ int main (int argc, char** argv)
       case 'l': arg_label      = optarg;               break;
       case 'x': arg_max        = atol (optarg);        break;
       case 'm': arg_min        = atol (optarg);        break;
-      case 'n': std::cout << time (nullptr) << std::endl; exit (0);
+      case 'n': printf ("%ld\n", (long) time (nullptr)); exit (0);
       case 'p': arg_percentage = true;                 break;
       case 'r': arg_remove     = true;                 break;
       case 's': arg_start      = atoi (optarg);        break;
       case 'v': showVersion ();                        break;
       case 'w': arg_width      = atoi (optarg);        break;
       case 'y': arg_style      = optarg;               break;
+      case 'Y': arg_format     = optarg;               break;
       case 'h': showUsage ();                          break;
+      case 'R': arg_rate       = true;                 break;
+      case 'B': arg_bytes      = true;                 break;
+      case 'Q': arg_steps      = true;                 break;
+      case 'S': arg_stream     = true;                 break;
+      case 'F': arg_fps        = atoi (optarg);        break;
+      case 'P': arg_pipe       = true;                 break;
+      case 'L': arg_pipe       = true;
+                arg_lines      = true;                 break;
+      case 'H': arg_shm        = optarg;               break;
+      case 'I': arg_init       = true;                 break;
+      case 'A': arg_adding     = true;
+                arg_add        = atol (optarg);        break;
+      case 'T': arg_state      = optarg;               break;
+      case 'E': arg_events     = optarg;               break;
+      case 'N': arg_interval   = atof (optarg);        break;
+      case 'W': arg_watch      = optarg;               break;
+      case 'D': arg_pid        = atoi (optarg);        break;
+      case 'O': arg_fd         = atoi (optarg);        break;
+      case 'j': arg_jobs       = atoi (optarg);        break;
+      case 'K': arg_trace      = optarg;               break;
+      case 'U': arg_metrics    = optarg;               break;
 
       default:
-        std::cout << "<default>" << std::endl;
+        puts ("<default>");
         break;
       }
     }
@@ -167,12 +266,87 @@ int main (int argc, char** argv)
     argc -= optind;
     argv += optind;
 
+    for (int i = 0; i < argc; ++i)
+      arg_command.push_back (argv[i]);
+
+    if (arg_format.length () && arg_style.length ())
+      throw std::string ("The --style and --format features cannot be combined.");
+
+    // Shared counters are created and advanced without drawing anything, so
+    // these need no terminal.
+    if ((arg_init || arg_adding) && ! arg_shm.length ())
+      throw std::string ("To use the --init or --add features, --shm must be provided.");
+
+    if (arg_init)
+    {
+      if (arg_max <= arg_min)
+        throw std::string ("To use the --init feature, --max must be provided.");
+
+      Counter::create (arg_shm, arg_min, arg_max);
+      return 0;
+    }
+
+    if (arg_adding)
+    {
+      Counter (arg_shm).add (arg_add);
+      return 0;
+    }
+
+    // Otherwise a shared counter supplies the range and start time.
+    std::unique_ptr <Counter> counter;
+    if (arg_shm.length ())
+    {
+      counter.reset (new Counter (arg_shm));
+      arg_min = counter->minimum ();
+      arg_max = counter->maximum ();
+      if (arg_start == 0)
+        arg_start = counter->start ();
+    }
+
+    // A process supplies the file, and its size is the default maximum.
+    if (arg_pid)
+    {
+      long size;
+      arg_fd = processFile (arg_pid, arg_fd, size);
+      if (! arg_max)
+        arg_max = size;
+    }
+
+    // A state file supplies whatever was given to an earlier invocation, and
+    // the first invocation starts the clock.
+    std::unique_ptr <State> state;
+    if (arg_state.length ())
+    {
+      if (arg_stream || arg_pipe || counter || arg_watch.length () || arg_pid || running)
+        throw std::string ("The --state feature cannot be combined with --stream, --pipe, --shm, --watch-file, --pid or run.");
+
+      state.reset (new State (arg_state));
+      if (! arg_min && ! arg_max)
+      {
+        arg_min = state->minimum ();
+        arg_max = state->maximum ();
+      }
+
+      if (arg_start == 0)
+        arg_start = state->empty () ? time (nullptr) : state->start ();
+
+      state->range (arg_min, arg_max, arg_start);
+    }
+
+    // In pipe mode, stdout carries the data, so the bar goes elsewhere.
+    int output = arg_pipe ? terminalOutput () : STDOUT_FILENO;
+    auto resizable = arg_width == 0;
+    if (resizable)
+      arg_width = terminalWidth (output);
+
     // Sanity check arguments.
     if (arg_min || arg_max)
       if (arg_min > arg_max)
         throw std::string ("The --max value must not be less than the --min value.");
 
-    if (arg_min || arg_max || arg_current)
+    auto watching = arg_watch.length () > 0;
+    auto attached = arg_pid != 0;
+    if (! arg_stream && ! arg_pipe && ! counter && ! watching && ! attached && ! running && (arg_min || arg_max || arg_current))
       if (arg_min > arg_current || arg_current > arg_max)
         throw std::string ("The --current value must not lie outside the --min/--max range.");
 
@@ -183,16 +357,45 @@ int main (int argc, char** argv)
     if (! arg_remove && ! (arg_min || arg_current || arg_max))
       showUsage ();
 
-    if (arg_elapsed && arg_start == 0)
-      throw std::string ("To use the --elapsed feature, --start must be provided.");
+    if ((arg_stream + arg_pipe + (counter != nullptr) + watching + attached + running) > 1)
+      throw std::string ("Only one of the --stream, --pipe, --shm, --watch-file and --pid features, or run, can be used.");
 
-    if (arg_estimate && arg_start == 0)
-      throw std::string ("To use the --estimate feature, --start must be provided.");
+    if (arg_pipe && arg_max <= arg_min)
+      throw std::string ("To use the ") + (arg_lines ? "--lines" : "--pipe") + " feature, --max must be provided.";
+
+    if (watching && arg_max <= arg_min)
+      throw std::string ("To use the --watch-file feature, --max must be provided.");
+
+    if (attached && arg_max <= arg_min)
+      throw std::string ("To use the --pid feature on anything but a regular file, --max must be provided.");
+
+    if (arg_fd != -1 && ! attached)
+      throw std::string ("To use the --fd feature, --pid must be provided.");
+
+    if (running && arg_max <= arg_min)
+      throw std::string ("To use the run command, --max must be provided.");
+
+    if (running && arg_command.empty ())
+      throw std::string ("To use the run command, a command must follow its options.");
+
+    if (arg_jobs && ! running)
+      throw std::string ("The --jobs value is only used by the run command.");
+
+    if (arg_jobs < 0)
+      throw std::string ("The --jobs value must not be negative.");
+
+    if (running && arg_jobs == 0)
+      arg_jobs = std::max (1L, sysconf (_SC_NPROCESSORS_ONLN));
+
+    // A long-lived process knows the start time.
+    if ((arg_stream || arg_pipe || watching || attached || running) && arg_start == 0)
+      arg_start = time (nullptr);
 
     // Disallow signals from stopping the program while it is displaying color codes
     // Set up and render Progress object.
     Progress p;
     p.style      = arg_style;
+    p.format     = arg_format;
     p.label      = arg_label;
     p.width      = arg_width;
     p.minimum    = arg_min;
@@ -202,15 +405,156 @@ int main (int argc, char** argv)
     p.start      = arg_start;
     p.elapsed    = arg_elapsed;
     p.estimate   = arg_estimate;
-    p.remove     = arg_remove;
-    p.update (arg_current);
+    p.rate       = arg_rate;
+    p.bytes      = arg_bytes;
+    p.steps      = arg_steps;
+    p.fps        = arg_fps;
+    p.fd         = output;
+
+    // Compiling the style or format checks it, and a format turns on exactly
+    // the fields that it names.
+    p.compile ();
+
+    if (p.elapsed && arg_start == 0)
+      throw std::string ("To use the --elapsed feature, --start must be provided.");
+
+    if (p.estimate && arg_start == 0)
+      throw std::string ("To use the --estimate feature, --start must be provided.");
+
+    if (arg_fps < 0)
+      throw std::string ("The --fps value must not be negative.");
+
+    if (arg_interval < 0)
+      throw std::string ("The --interval value must not be negative.");
+
+    if (arg_trace.length () && ! (arg_stream || arg_pipe || counter || watching || attached || running))
+      throw std::string ("The --trace feature needs --stream, --pipe, --shm, --watch-file, --pid or run.");
+
+    // A single update has no time since the previous one.
+    if (p.steps && ! (arg_stream || arg_pipe || counter || watching || attached || running))
+      throw std::string (arg_steps ? "The --steps feature needs" : "The {min}, {avg}, {p50} and {p99} format fields need")
+          + " --stream, --pipe, --shm, --watch-file, --pid or run.";
+
+    if (arg_pipe && arg_events == "-")
+      throw std::string ("In pipe mode, stdout carries the data, so --events needs a file.");
+
+    // Events go to stdout, or are appended to a file, so that successive
+    // invocations build one log.
+    int events = -1;
+    if (arg_events == "-")
+      events = STDOUT_FILENO;
+    else if (arg_events.length ())
+    {
+      events = open (arg_events.c_str (), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+      if (events == -1)
+        throw std::string ("The events file '") + arg_events + "' could not be opened: " + strerror (errno);
+    }
+
+    // The trace is recorded in memory, and written once the work is done.
+    std::unique_ptr <Trace> trace;
+    if (arg_trace.length ())
+      trace.reset (new Trace (arg_trace));
+
+    // The metrics file is replaced as the values change, at most once per
+    // interval, even across invocations.
+    std::unique_ptr <Metrics> metrics;
+    if (arg_metrics.length ())
+      metrics.reset (new Metrics (arg_metrics, (int) (arg_interval * 1000)));
+
+    p.events     = events;
+    p.interval   = (int) (arg_interval * 1000);
+    p.trace      = trace.get ();
+    p.metrics    = metrics.get ();
+
+    // A long-lived bar never waits for a slow terminal, or a slow reader of
+    // its events.
+    if (arg_stream || arg_pipe || counter || watching || attached || running)
+    {
+      p.fd = terminalNonblocking (output);
+      if (events != -1)
+        p.events = terminalNonblocking (events);
+    }
+
+    // In stream mode, one process renders every value read from stdin, which
+    // avoids a fork/exec per tick.
+    long failed = 0;
+    std::string broken;
+    if (arg_stream)
+      streamValues (p, resizable);
+    else if (arg_pipe)
+    {
+      // However the copy stops, the bar is finished.
+      try
+      {
+        if (! pipeThrough (p, arg_lines))
+          broken = "The output was closed before all of the input was copied.";
+      }
+      catch (const std::string& e)
+      {
+        broken = e;
+      }
 
-    if (p.remove)
       p.done ();
+    }
+    else if (counter)
+      watchCounter (p, *counter, arg_shm);
+    else if (watching)
+      watchFile (p, arg_watch);
+    else if (attached)
+      watchProcess (p, arg_pid, arg_fd);
+    else if (running)
+      failed = runCommands (p, resizable, arg_jobs, arg_command);
+    else
+    {
+      // Successive invocations append to one events file no more often than
+      // once per interval between them, which its last change tells, although
+      // the event at the maximum, which ends the run, is always written.
+      struct stat info;
+      if (events != -1 && arg_current != arg_max &&
+          fstat (events, &info) == 0 && S_ISREG (info.st_mode) && info.st_size > 0 &&
+          changedWithin (info, p.interval))
+        p.events = -1;
+
+      // Unless it is being removed, the frame that an earlier invocation drew
+      // is still shown, and if it would not change, it is not drawn again,
+      // although the new value is still reported.
+      if (state && ! arg_remove)
+      {
+        auto signature = p.signature (arg_current);
+        p.shown = signature == state->signature ();
+        state->record (signature);
+      }
+
+      p.update (arg_current);
+
+      if (p.remove)
+      {
+        p.done ();
+        if (state)
+          State::remove (arg_state);
+      }
+    }
+
+    if (trace)
+      trace->write ();
+
+    // The exit status tells a script whether every command succeeded, and
+    // whether all of the piped data arrived.
+    if (failed)
+    {
+      fprintf (stderr, "Error: %ld of the commands failed.\n", failed);
+      return 1;
+    }
+
+    if (broken.length ())
+    {
+      fprintf (stderr, "Error: %s\n", broken.c_str ());
+      return 1;
+    }
   }
 
-  catch (const std::string& e) { std::cerr << "Error: " << e << std::endl; }
-  catch (...)                  { std::cerr << "Unknown error occurred - please report." << std::endl; }
+  catch (const std::string& e) { fprintf (stderr, "Error: %s\n", e.c_str ()); }
+  catch (...)                  { fputs ("Unknown error occurred - please report.\n", stderr); }
 
   return 0;
 }
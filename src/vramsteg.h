@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_VRAMSTEG
+#define INCLUDED_VRAMSTEG
+
+/* The C interface to libvramsteg, for drawing a progress bar in-process.
+ *
+ *   vramsteg_t* bar = vramsteg_create ();
+ *   vramsteg_set (bar, VRAMSTEG_MAXIMUM, 100);
+ *   vramsteg_set (bar, VRAMSTEG_PERCENTAGE, 1);
+ *   for (long i = 0; i <= 100; ++i)
+ *     vramsteg_update (bar, i);
+ *   vramsteg_done (bar);
+ *   vramsteg_destroy (bar);
+ *
+ * Functions that can fail return 0 on success, or -1, in which case
+ * vramsteg_error describes the problem.  A vramsteg_t must not be used by
+ * more than one thread at a time.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The shared library exports only these functions. */
+#if defined (__GNUC__) && __GNUC__ >= 4
+#define VRAMSTEG_API __attribute__ ((visibility ("default")))
+#else
+#define VRAMSTEG_API
+#endif
+
+typedef struct vramsteg vramsteg_t;
+
+/* Options for vramsteg_set.  Values are only ever added to this list. */
+enum vramsteg_option
+{
+  VRAMSTEG_MINIMUM    = 1,  /* Equivalent to 0%, default 0                    */
+  VRAMSTEG_MAXIMUM    = 2,  /* Equivalent to 100%, default 0                  */
+  VRAMSTEG_WIDTH      = 3,  /* Width, default 0 meaning full terminal width   */
+  VRAMSTEG_START      = 4,  /* Start time epoch, default the creation time    */
+  VRAMSTEG_PERCENTAGE = 5,  /* Show percentage, default 0                     */
+  VRAMSTEG_ELAPSED    = 6,  /* Show elapsed time, default 0                   */
+  VRAMSTEG_ESTIMATE   = 7,  /* Show estimated remaining time, default 0       */
+  VRAMSTEG_REMOVE     = 8,  /* Remove the bar when done, default 0            */
+  VRAMSTEG_FPS        = 9,  /* Maximum redraws per second, default unlimited  */
+  VRAMSTEG_FD         = 10, /* File descriptor to draw on, default stdout     */
+  VRAMSTEG_RATE       = 11, /* Show the rate per second, default 0            */
+  VRAMSTEG_BYTES      = 12, /* Show the rate in bytes, default 0              */
+  VRAMSTEG_NONBLOCK   = 13, /* Drop frames a slow terminal cannot take, def 0 */
+  VRAMSTEG_EVENTS     = 14, /* File descriptor for JSON events, default none  */
+  VRAMSTEG_INTERVAL   = 15, /* Milliseconds between events, default 1000      */
+  VRAMSTEG_STEPS      = 16  /* Show the times between updates, default 0     */
+};
+
+/* Options for vramsteg_set_text. */
+enum vramsteg_text_option
+{
+  VRAMSTEG_STYLE      = 1,  /* Style name, default ""                         */
+  VRAMSTEG_LABEL      = 2,  /* Label, default ""                              */
+  VRAMSTEG_FORMAT     = 3   /* Template, instead of the style and fields    */
+};
+
+VRAMSTEG_API vramsteg_t* vramsteg_create (void);
+VRAMSTEG_API void vramsteg_destroy (vramsteg_t*);
+
+VRAMSTEG_API int vramsteg_set (vramsteg_t*, enum vramsteg_option, long);
+VRAMSTEG_API int vramsteg_set_text (vramsteg_t*, enum vramsteg_text_option, const char*);
+
+VRAMSTEG_API int vramsteg_update (vramsteg_t*, long);
+VRAMSTEG_API int vramsteg_done (vramsteg_t*);
+
+VRAMSTEG_API const char* vramsteg_error (const vramsteg_t*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
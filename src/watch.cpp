@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <main.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <cerrno>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef LINUX
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+// The size of the file, or zero if it does not exist yet.
+static long fileSize (const std::string& path)
+{
+  struct stat info;
+  return stat (path.c_str (), &info) == 0 ? (long) info.st_size : 0;
+}
+
+#ifdef LINUX
+////////////////////////////////////////////////////////////////////////////////
+// The directory holding the file is watched, rather than the file itself, so
+// that the file may be created, or replaced by renaming another over it, after
+// the watch begins.  The size is only read when inotify reports a change to
+// the file, and once for each batch of changes.  An interrupt ends the watch
+// early.
+void watchFile (Progress& progress, const std::string& path)
+{
+  auto slash     = path.rfind ('/');
+  auto directory = slash == std::string::npos ? std::string (".")
+                 : slash == 0                 ? std::string ("/")
+                 :                              path.substr (0, slash);
+  auto name      = slash == std::string::npos ? path : path.substr (slash + 1);
+
+  auto changes = inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+  if (changes == -1)
+    throw std::string ("Could not watch '") + path + "': " + strerror (errno);
+
+  if (inotify_add_watch (changes, directory.c_str (),
+                         IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO) == -1)
+  {
+    auto error = errno;
+    close (changes);
+    throw std::string ("Could not watch '") + path + "': " + strerror (error);
+  }
+
+  sigset_t blocked;
+  auto signals_fd = signalsQueue (blocked, false);
+
+  auto ticking = progress.elapsed || progress.estimate || progress.rate;
+  auto size    = fileSize (path);
+  progress.update (size);
+
+  alignas (struct inotify_event) char buffer[4096];
+  while (size < progress.maximum)
+  {
+    // A frame held back by throttling, or dropped by a slow terminal, is owed.
+    auto timeout = ticking ? untilNextSecond () : -1;
+    if (progress.pending ())
+    {
+      auto owed = progress.fps > 0 ? std::max (1, 1000 / progress.fps) : 100;
+      timeout = timeout == -1 ? owed : std::min (timeout, owed);
+    }
+
+    struct pollfd ready[2] {{changes, POLLIN, 0}, {signals_fd, POLLIN, 0}};
+    auto count = poll (ready, 2, timeout);
+    if (count == -1 && errno != EINTR)
+      break;
+
+    if (ready[1].revents & POLLIN)
+      break;
+
+    auto changed = false;
+    ssize_t length;
+    while ((length = read (changes, buffer, sizeof (buffer))) > 0)
+    {
+      for (char* event = buffer; event < buffer + length; )
+      {
+        auto change = reinterpret_cast <struct inotify_event*> (event);
+        if (change->len && name == change->name)
+          changed = true;
+
+        event += sizeof (struct inotify_event) + change->len;
+      }
+    }
+
+    // Changes to other files in the directory draw nothing.
+    if (changed)
+      size = fileSize (path);
+
+    if (changed || count == 0)
+      progress.update (size);
+  }
+
+  signalsRelease (signals_fd, blocked);
+  close (changes);
+
+  progress.done ();
+}
+
+#else
+////////////////////////////////////////////////////////////////////////////////
+// Without inotify, the size is sampled at the fps setting, or 10 times per
+// second.
+void watchFile (Progress& progress, const std::string& path)
+{
+  auto period = std::chrono::nanoseconds (1000000000 / (progress.fps > 0 ? progress.fps : 10));
+  progress.fps = 0;
+
+  while (true)
+  {
+    auto size = fileSize (path);
+    progress.update (size);
+    if (size >= progress.maximum)
+      break;
+
+    std::this_thread::sleep_for (period);
+  }
+
+  progress.done ();
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
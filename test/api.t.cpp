@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <vramsteg.h>
+#include <string>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <test.h>
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (22);
+
+  auto bar = vramsteg_create ();
+  t.ok (bar != nullptr,                                              "vramsteg_create");
+
+  auto null = open ("/dev/null", O_WRONLY);
+  t.is (vramsteg_set (bar, VRAMSTEG_FD, null), 0,                    "vramsteg_set VRAMSTEG_FD");
+  t.is (vramsteg_set (bar, VRAMSTEG_MAXIMUM, 100), 0,                "vramsteg_set VRAMSTEG_MAXIMUM");
+  t.is (vramsteg_set (bar, VRAMSTEG_PERCENTAGE, 1), 0,               "vramsteg_set VRAMSTEG_PERCENTAGE");
+  t.is (vramsteg_set (bar, VRAMSTEG_NONBLOCK, 1), 0,                 "vramsteg_set VRAMSTEG_NONBLOCK");
+  t.is (vramsteg_set_text (bar, VRAMSTEG_LABEL, "label"), 0,         "vramsteg_set_text VRAMSTEG_LABEL");
+  t.is (vramsteg_set_text (bar, VRAMSTEG_STYLE, "text"), 0,          "vramsteg_set_text VRAMSTEG_STYLE");
+
+  // A rejected value leaves the bar as it was.
+  t.is (vramsteg_set_text (bar, VRAMSTEG_STYLE, "bogus"), -1,       "vramsteg_set_text VRAMSTEG_STYLE bogus fails");
+  t.is (vramsteg_set (bar, VRAMSTEG_PERCENTAGE, 0), 0,               "vramsteg_set after a rejected style");
+  t.is (vramsteg_set_text (bar, VRAMSTEG_STYLE, "mono"), 0,          "vramsteg_set_text VRAMSTEG_STYLE after a rejected style");
+
+  // Errors are returned, and described.
+  t.is (vramsteg_set (bar, VRAMSTEG_FPS, -1), -1,                    "vramsteg_set VRAMSTEG_FPS -1 fails");
+  t.is (vramsteg_error (bar), "The fps value must not be negative.", "vramsteg_error describes the failure");
+  t.is (vramsteg_set (bar, (vramsteg_option) 999, 1), -1,            "vramsteg_set unknown option fails");
+  t.is (vramsteg_set_text (bar, VRAMSTEG_FORMAT, "{size}"), -1,     "vramsteg_set_text VRAMSTEG_FORMAT fails");
+  t.is (vramsteg_set_text (bar, VRAMSTEG_FORMAT, "[{bar:#}]"), 0,    "vramsteg_set_text VRAMSTEG_FORMAT");
+  t.is (vramsteg_set (nullptr, VRAMSTEG_MAXIMUM, 1), -1,             "vramsteg_set without a bar fails");
+
+  int failures = 0;
+  for (long i = 0; i <= 100; ++i)
+    failures += vramsteg_update (bar, i) != 0;
+
+  t.is (failures, 0,                                                 "vramsteg_update");
+  t.is (vramsteg_done (bar), 0,                                      "vramsteg_done");
+
+  vramsteg_destroy (bar);
+
+  // An update needs a range.
+  bar = vramsteg_create ();
+  vramsteg_set (bar, VRAMSTEG_FD, null);
+  t.is (vramsteg_update (bar, 0), -1,                                "vramsteg_update without a maximum fails");
+  vramsteg_set (bar, VRAMSTEG_MAXIMUM, 10);
+  t.is (vramsteg_update (bar, 5), 0,                                 "vramsteg_update once the maximum is set");
+  vramsteg_set (bar, VRAMSTEG_MAXIMUM, 0);
+  t.is (vramsteg_update (bar, 0), -1,                                "vramsteg_update with an empty range fails");
+  vramsteg_destroy (bar);
+
+  // Events are written without a terminal.
+  int ends[2];
+  pipe (ends);
+  bar = vramsteg_create ();
+  vramsteg_set (bar, VRAMSTEG_FD, null);
+  vramsteg_set (bar, VRAMSTEG_MAXIMUM, 10);
+  vramsteg_set (bar, VRAMSTEG_EVENTS, ends[1]);
+  vramsteg_update (bar, 5);
+  vramsteg_done (bar);
+  vramsteg_destroy (bar);
+  close (ends[1]);
+
+  char events[1024] {};
+  read (ends[0], events, sizeof (events) - 1);
+  close (ends[0]);
+  t.ok (strstr (events, "\"value\":5,") && strstr (events, "\"done\":true}\n"),
+                                                                     "VRAMSTEG_EVENTS writes JSON events");
+  close (null);
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
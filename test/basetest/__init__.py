@@ -2,6 +2,7 @@
 
 from .testing import TestCase
 from .vramsteg import Vramsteg
+from .screen import Screen
 
 # flake8:noqa
 # vim: ai sts=4 et sw=4
@@ -0,0 +1,92 @@
+# -*- coding: utf-8 -*-
+
+import re
+
+
+class Screen(object):
+    """A minimal terminal model, for checking what vramsteg draws
+
+    Only the control sequences vramsteg emits are understood: carriage return,
+    line feed, cursor up, down and forward, line and screen erasure, and SGR
+    attributes, which are ignored.  The screen grows downwards without limit.
+    """
+    SEQUENCE = re.compile(r"\x1b\[([0-9;]*)([A-Za-z])")
+
+    def __init__(self):
+        self.rows = [[]]
+        self.row = 0
+        self.column = 0
+
+    def feed(self, data):
+        """Applies the bytes written to the terminal, returning self"""
+        i = 0
+        while i < len(data):
+            match = self.SEQUENCE.match(data, i)
+            if match:
+                self._sequence(match.group(1), match.group(2))
+                i = match.end()
+                continue
+
+            c = data[i]
+            if c == "\r":
+                self.column = 0
+            elif c == "\n":
+                self._move(self.row + 1)
+            else:
+                self._put(c)
+            i += 1
+        return self
+
+    def history(self, data):
+        """Applies the bytes a carriage return at a time, which never splits a
+        control sequence, returning the text of the screen after each"""
+        texts = []
+        for chunk in re.findall(r"[^\r]*\r|[^\r]+$", data):
+            texts.append(self.feed(chunk).text())
+        return texts
+
+    def lines(self):
+        """The text on each row, without trailing blanks"""
+        return ["".join(row).rstrip() for row in self.rows]
+
+    def text(self):
+        """The screen as text, without trailing blank rows"""
+        lines = self.lines()
+        while lines and lines[-1] == "":
+            lines.pop()
+        return "\n".join(lines)
+
+    def _sequence(self, args, command):
+        n = int(args) if args.isdigit() else 1
+        if command == "A":
+            self._move(max(0, self.row - n))
+        elif command == "B":
+            self._move(self.row + n)
+        elif command == "C":
+            self.column += n
+        elif command == "K":
+            row = self.rows[self.row]
+            if args == "2":
+                del row[:]
+            else:
+                del row[self.column:]
+        elif command == "J":
+            del self.rows[self.row][self.column:]
+            del self.rows[self.row + 1:]
+
+    def _move(self, row):
+        while len(self.rows) <= row:
+            self.rows.append([])
+        self.row = row
+
+    def _put(self, c):
+        row = self.rows[self.row]
+        while len(row) < self.column:
+            row.append(" ")
+        if self.column < len(row):
+            row[self.column] = c
+        else:
+            row.append(c)
+        self.column += 1
+
+# vim: ai sts=4 et sw=4
@@ -1,11 +1,14 @@
 # -*- coding: utf-8 -*-
 
 import atexit
+import errno
 import json
 import os
 import shlex
 import shutil
+import subprocess
 import tempfile
+import time
 import unittest
 from .exceptions import CommandError
 from .utils import run_cmd_wait, run_cmd_wait_nofail, which, vramsteg_binary_location, DEFAULT_EXTENSION_PATH
@@ -37,8 +40,6 @@ class Vramsteg(object):
         self.datadir = tempfile.mkdtemp(prefix="vramsteg_")
         self.vramstegrc = os.path.join (self.datadir, 'vramstegrc')
 
-        self._command.extend(['-f', self.vramstegrc])
-
         # Ensure any instance is properly destroyed at session end
         atexit.register(lambda: self.destroy())
 
@@ -165,6 +166,50 @@ class Vramsteg(object):
 
         return output
 
+    def tty(self, args="", input=None, delay=0, signal=None):
+        """Invoke vramsteg with its output on a pseudo-terminal, and return
+        everything written to that terminal.
+
+        If input is given it is written to stdin, which is closed after waiting
+        for delay seconds, or, if a signal is given, that signal is sent after
+        the delay instead.
+        """
+        command = self._command[:]
+        command.extend(self._split_string_args_if_string(args))
+
+        master, slave = os.openpty()
+        p = subprocess.Popen(command, stdout=slave, env=self.env,
+                             stdin=subprocess.PIPE if input is not None else None)
+        os.close(slave)
+
+        if input is not None:
+            p.stdin.write(input)
+            p.stdin.flush()
+
+        time.sleep(delay)
+        if signal is not None:
+            p.send_signal(signal)
+        if input is not None:
+            p.stdin.close()
+
+        # Reading until the terminal hangs up, so that a full terminal never
+        # blocks the program.
+        out = ""
+        while True:
+            try:
+                chunk = os.read(master, 4096)
+            except OSError as e:
+                if e.errno != errno.EIO:
+                    raise
+                break
+            if not chunk:
+                break
+            out += chunk
+
+        os.close(master)
+        p.wait()
+        return out
+
     def destroy(self):
         """Cleanup the data folder and release server port for other instances
         """
@@ -0,0 +1,149 @@
+#!/usr/bin/env python2.7
+# -*- coding: utf-8 -*-
+###############################################################################
+#
+# Copyright 2006 - 2017, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# http://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import sys
+import os
+import unittest
+import re
+import json
+import time
+import tempfile
+import threading
+import subprocess
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Vramsteg, TestCase
+from basetest.utils import run_cmd_wait
+
+# Test methods available:
+#     self.assertEqual(a, b)
+#     self.assertNotEqual(a, b)
+#     self.assertTrue(x)
+#     self.assertFalse(x)
+#     self.assertIs(a, b)
+#     self.assertIsNot(substring, text)
+#     self.assertIsNone(x)
+#     self.assertIsNotNone(x)
+#     self.assertIn(substring, text)
+#     self.assertNotIn(substring, text
+#     self.assertRaises(e)
+#     self.assertRegexpMatches(text, pattern)
+#     self.assertNotRegexpMatches(text, pattern)
+#     self.tap("")
+
+class TestEvents(TestCase):
+    def setUp(self):
+        self.t = Vramsteg()
+
+    def events(self, out):
+        return [json.loads(line) for line in out.splitlines()]
+
+    def paced(self, args, values):
+        """Feeds values to vramsteg one at a time, returning the events"""
+        p = subprocess.Popen([self.t.vramsteg] + args.split(),
+                             stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+        for value in values:
+            p.stdin.write("%d\n" % value)
+            p.stdin.flush()
+            time.sleep(0.05)
+        out, err = p.communicate()
+        return self.events(out)
+
+    def test_events_without_terminal(self):
+        """Verify that 'vramsteg --events -' reports progress without a terminal"""
+        events = self.paced("--stream --max 10 --events - --interval 0", [2, 5, 10])
+        self.assertEqual([e["value"] for e in events], [2, 5, 10, 10])
+        self.assertEqual(events[1]["fraction"], 0.5)
+        self.assertEqual([e["done"] for e in events], [False, False, False, True])
+        for key in ("time", "label", "minimum", "maximum", "rate", "eta", "elapsed"):
+            self.assertIn(key, events[0])
+
+    def test_events_interval(self):
+        """Verify that 'vramsteg --events' writes no more than one event per interval"""
+        events = self.paced("--stream --max 10 --events - --interval 60", range(6))
+        self.assertEqual([e["value"] for e in events], [0, 5])
+        self.assertEqual([e["done"] for e in events], [False, True])
+
+    def test_events_named_bars(self):
+        """Verify that 'vramsteg --events' labels the events of named bars, once done"""
+        code, out, err = self.t("--stream --max 10 --events - --label 'x \"y\"'",
+                                input="a 1\nbb 2\na done\n")
+        events = self.events(out)
+        self.assertEqual([(e["label"], e["done"]) for e in events],
+                         [("a", False), ("bb", False), ("a", True), ("bb", True)])
+
+    def test_events_file(self):
+        """Verify that 'vramsteg --events' appends to a file, once per interval across invocations"""
+        path = tempfile.mktemp()
+        try:
+            self.t("--max 10 --current 3 --events " + path)
+            self.t("--max 10 --current 4 --events " + path)
+            self.t("--max 10 --current 5 --events " + path + " --interval 0")
+            self.t("--max 10 --current 10 --events " + path)
+            with open(path) as f:
+                events = self.events(f.read())
+            self.assertEqual([e["value"] for e in events], [3, 5, 10])
+        finally:
+            os.remove(path)
+
+    def test_events_slow_reader(self):
+        """Verify that 'vramsteg --stream --events -' keeps reading its input while nobody reads the events"""
+        reader, writer = os.pipe()
+        p = subprocess.Popen([self.t.vramsteg, "--stream", "--max", "10", "--events", "-"],
+                             stdin=subprocess.PIPE, stdout=writer)
+        os.close(writer)
+
+        # Far more events than the pipe holds, and more input than its pipe holds.
+        def feed():
+            p.stdin.write("".join("bar%d%s 1\n" % (i, "x" * 1000) for i in range(2000)))
+            p.stdin.close()
+
+        feeder = threading.Thread(target=feed)
+        feeder.start()
+        feeder.join(5)
+        consumed = not feeder.is_alive()
+
+        with os.fdopen(reader) as f:
+            events = self.events(f.read())
+        feeder.join()
+        p.wait()
+        self.assertTrue(consumed)
+        self.assertEqual(events[-1]["done"], True)
+
+    def test_events_pipe_stdout(self):
+        """Verify that 'vramsteg --pipe --events -' is rejected"""
+        code, out, err = self.t("--pipe --max 10 --events -", input="")
+        self.assertIn("In pipe mode, stdout carries the data, so --events needs a file.", err)
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+    unittest.main(testRunner=TAPTestRunner())
+
+# vim: ai sts=4 et sw=4 ft=python
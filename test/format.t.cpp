@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <Format.h>
+#include <Progress.h>
+#include <string>
+#include <test.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// The text of a frame, without control sequences.
+static std::string visible (const Progress& progress)
+{
+  std::string bytes (progress.frame ().data (), progress.frame ().size ());
+  std::string text;
+  for (size_t i = 0; i < bytes.length (); ++i)
+  {
+    if (bytes[i] == '\033')
+      i = bytes.find_first_of ("Cm", i);
+    else if (bytes[i] != '\r')
+      text += bytes[i];
+  }
+
+  return text;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static std::string render (const std::string& format, long value)
+{
+  Progress progress;
+  progress.format  = format;
+  progress.label   = "job";
+  progress.width   = 30;
+  progress.maximum = 100;
+  progress.refresh (value);
+  return visible (progress);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static std::string error (const std::string& format)
+{
+  try
+  {
+    Format f;
+    f.compile (format);
+  }
+
+  catch (const std::string& e)
+  {
+    return e;
+  }
+
+  return "";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (12);
+
+  Format f;
+  f.compile ("{label }[{bar:#-}]{ pct}");
+  t.is (f.steps ().size (), (size_t) 5,              "Template compiles to five steps");
+  t.is (f.steps ()[0].after, std::string (" "),      "Text after a field name stays with it");
+  t.is (f.steps ()[3].before, std::string ("]"),     "Literal text is a step of its own");
+  t.ok (f.uses (Format::Percent),                     "Template uses the percentage");
+  t.notok (f.uses (Format::Rate),                     "Template does not use the rate");
+
+  // The bar takes whatever the other fields leave.
+  t.is (render ("{label }[{bar:#-}]{ pct}", 50),
+        std::string ("job [#########----------]  50%"),
+                                                     "Bar fills the width left");
+  t.is (render ("{pct} {{done}}", 100),
+        std::string ("100% {done}"),                 "Braces are doubled, and a bar is optional");
+  t.is (render ("{label: }{bar:=}|", 20),
+        std::string ("job: ====                    |"),  "Bar defaults to blank for the rest");
+
+  t.is (error ("{pct"),  std::string ("Format '{pct' has an unmatched '{'."),
+                                                     "Unmatched brace is an error");
+  t.is (error ("{size}"), std::string ("Format field 'size' not supported."),
+                                                     "Unknown field is an error");
+  t.is (error ("{bar}{bar}"), std::string ("Format '{bar}{bar}' has more than one bar."),
+                                                     "Second bar is an error");
+  t.is (error (Format::style ("text")), std::string (""),
+                                                     "Styles are templates");
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
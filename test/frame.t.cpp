@@ -0,0 +1,242 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <Frame.h>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <test.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// A minimal terminal, which understands just enough to apply encoded frames to
+// a single line: carriage return, cursor forward, SGR and printable text.
+class Line
+{
+public:
+  void apply (const Frame& frame)
+  {
+    std::string bytes (frame.data (), frame.size ());
+    for (size_t i = 0; i < bytes.length (); ++i)
+    {
+      if (bytes[i] == '\r')
+        _column = 0;
+
+      else if (bytes[i] == '\033')
+      {
+        auto end = bytes.find_first_of ("Cm", i);
+        auto sequence = bytes.substr (i, end - i + 1);
+        if (bytes[end] == 'C')
+          _column += atoi (sequence.c_str () + 2);
+        else
+          _attribute = sequence == "\033[0m" ? "" : sequence;
+
+        i = end;
+      }
+      else
+      {
+        if (_column >= (int) _cells.size ())
+          _cells.resize (_column + 1);
+
+        _cells[_column++] = _attribute + bytes[i];
+      }
+    }
+  }
+
+  std::string screen () const
+  {
+    std::string result;
+    for (auto& cell : _cells)
+      result += cell.length () ? cell : " ";
+
+    return result;
+  }
+
+private:
+  std::vector <std::string> _cells {};
+  std::string _attribute {};
+  int _column {0};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+static void bar (Frame& frame, int visible, int percent)
+{
+  frame.clear ();
+  frame.text ("label ");
+  frame.attribute ("\033[42m");
+  frame.fill (' ', visible);
+  frame.attribute ("\033[41m");
+  frame.fill (' ', 60 - visible);
+  frame.attribute (nullptr);
+  frame.text (" ");
+  frame.number (percent, 3);
+  frame.text ("%");
+  frame.encode ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static std::string text (Frame& frame)
+{
+  return std::string (frame.data (), frame.size ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (18);
+
+  // Formatting.
+  Frame frame;
+  frame.clear ();
+  frame.number (42, 4);
+  frame.text (" ");
+  frame.number (-7, 0);
+  frame.encode ();
+  t.is (text (frame), "  42 -7\r",                "number: right-aligned, signed");
+
+  frame.invalidate ();
+  frame.clear ();
+  frame.time (59);
+  frame.text (" ");
+  frame.time (3661);
+  frame.text (" ");
+  frame.time (90061);
+  frame.encode ();
+  t.is (text (frame), "00:59 1:01:01 1d 1:01:01\r", "time: MM:SS, H:MM:SS, Dd H:MM:SS");
+  t.is (Frame::timeWidth (59),    5,              "timeWidth: MM:SS");
+  t.is (Frame::timeWidth (3661),  7,              "timeWidth: H:MM:SS");
+  t.is (Frame::timeWidth (90061), 10,             "timeWidth: Dd H:MM:SS");
+
+  // The first frame is encoded in full.
+  frame.invalidate ();
+  frame.clear ();
+  frame.text ("ab");
+  frame.attribute ("\033[42m");
+  frame.fill (' ', 2);
+  frame.attribute (nullptr);
+  frame.text ("c");
+  frame.encode ();
+  t.is (text (frame), "ab\033[42m  \033[0mc\r",    "encode: full frame, SGR on change only");
+
+  // An identical frame needs no output.
+  frame.clear ();
+  frame.text ("ab");
+  frame.attribute ("\033[42m");
+  frame.fill (' ', 2);
+  frame.attribute (nullptr);
+  frame.text ("c");
+  frame.encode ();
+  t.is ((int) frame.size (), 0,                   "encode: unchanged frame emits nothing");
+
+  // Only the changed cells are emitted, and the result looks the same as a
+  // full repaint, for a fraction of the bytes.
+  Frame full;
+  Line incremental;
+  Line repainted;
+  frame.invalidate ();
+  size_t incremental_bytes = 0;
+  size_t repainted_bytes = 0;
+  for (int step = 0; step <= 10; ++step)
+  {
+    bar (frame, step * 6, step * 10);
+    incremental.apply (frame);
+    incremental_bytes += frame.size ();
+
+    full.invalidate ();
+    bar (full, step * 6, step * 10);
+    repainted.apply (full);
+    repainted_bytes += full.size ();
+
+    if (step == 5)
+    {
+      t.is (text (frame), "\033[30C\033[42m      \033[32C\033[0m5\r",
+                                                  "encode: only the changed cells");
+      t.is (incremental.screen (), repainted.screen (),
+                                                  "encode: halfway, same screen as a repaint");
+    }
+  }
+
+  t.is (incremental.screen (), repainted.screen (), "encode: finished, same screen as a repaint");
+  t.ok (incremental_bytes * 2 < repainted_bytes,  "encode: less than half the bytes of a repaint");
+  t.diag ("bytes: incremental " + std::to_string (incremental_bytes) +
+          ", repainted " + std::to_string (repainted_bytes));
+
+  // A shorter row blanks the cells that are no longer used.
+  Line line;
+  frame.invalidate ();
+  frame.clear ();
+  frame.text ("abcdef");
+  frame.encode ();
+  line.apply (frame);
+  frame.clear ();
+  frame.text ("abc");
+  frame.encode ();
+  line.apply (frame);
+  t.is (text (frame), "abc   \r",                 "encode: shorter row blanks the remainder");
+  t.is (line.screen (), "abc   ",                 "encode: shorter row, same screen");
+
+  // Small gaps between changes are repainted rather than skipped.
+  frame.clear ();
+  frame.text ("xbcdefgz");
+  frame.encode ();
+  t.is (text (frame), "xbcdefgz\r",               "encode: small gaps are repainted");
+
+  // A frame that was composed but never encoded says nothing about the screen.
+  frame.clear ();
+  frame.text ("lost");
+  frame.clear ();
+  frame.text ("xbcdefgz");
+  frame.encode ();
+  t.is (text (frame), "xbcdefgz\r",               "encode: unencoded frame forces a repaint");
+
+  // After invalidation, the frame is repainted.
+  frame.invalidate ();
+  frame.clear ();
+  frame.text ("xbcdefgz");
+  frame.encode ();
+  t.is (text (frame), "xbcdefgz\r",               "invalidate: repaint");
+
+  // Emitted bytes follow the encoded frame.
+  frame.emit ("\n");
+  t.is (text (frame), "xbcdefgz\r\n",             "emit: raw bytes appended");
+
+  // Overflow is an error, not a crash.
+  std::string error;
+  try
+  {
+    frame.clear ();
+    frame.fill (' ', 100000);
+  }
+  catch (const std::string& e)
+  {
+    error = e;
+  }
+  t.is (error, "The specified width is too large.", "fill: overflow is reported");
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <Histogram.h>
+#include <Progress.h>
+#include <string>
+#include <test.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// The text of a frame, without control sequences.
+static std::string visible (const Progress& progress)
+{
+  std::string bytes (progress.frame ().data (), progress.frame ().size ());
+  std::string text;
+  for (size_t i = 0; i < bytes.length (); ++i)
+  {
+    if (bytes[i] == '\033')
+      i = bytes.find_first_of ("Cm", i);
+    else if (bytes[i] != '\r')
+      text += bytes[i];
+  }
+
+  return text;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (14);
+
+  Histogram h;
+  t.is ((int) h.count (), 0,                            "Empty histogram");
+  t.is ((int) h.percentile (0.5), 0,                    "Empty histogram has no percentiles");
+
+  // 90 fast steps of 1ms, and 10 slow ones of 50ms.
+  for (int i = 0; i < 90; ++i)
+    h.add (1000000);
+  for (int i = 0; i < 10; ++i)
+    h.add (50000000);
+
+  t.is ((int) h.count (), 100,                          "Every duration is counted");
+  t.is ((int) h.minimum (), 1000000,                    "Minimum is exact");
+  t.is ((int) h.maximum (), 50000000,                   "Maximum is exact");
+  t.is ((int) h.mean (), 5900000,                       "Mean is exact");
+  t.ok (h.percentile (0.5) > 970000 && h.percentile (0.5) < 1030000,
+                                                        "Median is within 3%");
+  t.ok (h.percentile (0.99) > 48500000 && h.percentile (0.99) <= 50000000,
+                                                        "99th percentile is within 3%");
+
+  t.is (Histogram::format (Histogram::round (850)),        std::string ("850ns"), "Nanoseconds");
+  t.is (Histogram::format (Histogram::round (1234567)),    std::string ("1.2ms"), "Milliseconds, to one place");
+  t.is (Histogram::format (Histogram::round (9960000)),    std::string ("10ms"),  "Rounding carries into the next unit");
+  t.is (Histogram::format (Histogram::round (1250000000000)), std::string ("21m"), "Minutes");
+
+  // Until there are two updates, there is no time between them.
+  Progress progress;
+  progress.style   = "text";
+  progress.width   = 60;
+  progress.maximum = 100;
+  progress.steps   = true;
+  progress.measure ();
+  progress.refresh (1);
+  t.is (visible (progress).substr (37), std::string ("    -/    -/    -/    -"),
+                                                        "Step times start as dashes");
+  progress.measure ();
+  progress.invalidate ();
+  progress.refresh (2);
+  t.is (visible (progress).length (), (size_t) 60,     "Step times have a constant width");
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <main.h>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <test.h>
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (11);
+
+  t.is ((int) countLines ("", 0), 0,                         "countLines empty");
+  t.is ((int) countLines ("a\nb\nc", 5), 2,                  "countLines ignores a last line without a newline");
+
+  // Every byte a newline overflows any byte-wide counter that is not summed.
+  std::string all (100000, '\n');
+  t.is ((int) countLines (all.data (), all.size ()), 100000, "countLines counts 100000 newlines in a row");
+
+  // Random lengths, densities and alignments exercise the tails.
+  srand (1);
+  int mismatches = 0;
+  for (int i = 0; i < 2000; ++i)
+  {
+    std::string text (rand () % 3000 + 64, 'x');
+    int density = rand () % 100 + 1;
+    for (auto& c : text)
+      if (rand () % density == 0)
+        c = '\n';
+
+    size_t offset = rand () % 33;
+    size_t length = text.size () - offset - rand () % 31;
+    auto expected = std::count (text.begin () + offset, text.begin () + offset + length, '\n');
+    mismatches += countLines (text.data () + offset, length) != (size_t) expected;
+  }
+
+  t.is (mismatches, 0,                                       "countLines matches a byte count at any length and alignment");
+
+  std::string text ("\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n", 33);
+  t.is ((int) countLines (text.data () + 1, 32), 32,         "countLines counts an unaligned 32-byte block");
+
+  // Each vector implementation is checked against the scalar count, whichever
+  // one the processor would choose.
+  std::string sample (20000, 'x');
+  for (auto& c : sample)
+    if (rand () % 7 == 0)
+      c = '\n';
+
+  for (auto name : {"sse2", "avx2"})
+  {
+    std::string kernel = name;
+    try
+    {
+      countLines ("", 0, kernel);
+    }
+    catch (const std::string&)
+    {
+      t.skip ("countLines " + kernel + " is not supported");
+      t.skip ("countLines " + kernel + " is not supported");
+      t.skip ("countLines " + kernel + " is not supported");
+      continue;
+    }
+
+    t.is (countLines (all.data (), all.size (), kernel), (size_t) 100000,
+          "countLines " + kernel + " counts 100000 newlines in a row");
+
+    // Every unaligned head, and every tail shorter than two vectors.
+    int edges = 0;
+    for (size_t offset = 0; offset < 32; ++offset)
+      for (size_t length = 0; length < 80; ++length)
+        edges += countLines (sample.data () + offset, length, kernel) !=
+                 countLines (sample.data () + offset, length, "scalar");
+
+    t.is (edges, 0, "countLines " + kernel + " matches the scalar count at every short length and alignment");
+
+    // Long runs, across the summing of the byte counters.
+    int runs = 0;
+    for (int i = 0; i < 200; ++i)
+    {
+      size_t offset = rand () % 32;
+      size_t length = rand () % (sample.size () - offset);
+      runs += countLines (sample.data () + offset, length, kernel) !=
+              countLines (sample.data () + offset, length, "scalar");
+    }
+
+    t.is (runs, 0, "countLines " + kernel + " matches the scalar count at any length");
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
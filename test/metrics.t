@@ -0,0 +1,137 @@
+#!/usr/bin/env python2.7
+# -*- coding: utf-8 -*-
+###############################################################################
+#
+# Copyright 2006 - 2017, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# http://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import sys
+import os
+import unittest
+import shutil
+import tempfile
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Vramsteg, TestCase
+
+# Test methods available:
+#     self.assertEqual(a, b)
+#     self.assertNotEqual(a, b)
+#     self.assertTrue(x)
+#     self.assertFalse(x)
+#     self.assertIs(a, b)
+#     self.assertIsNot(substring, text)
+#     self.assertIsNone(x)
+#     self.assertIsNotNone(x)
+#     self.assertIn(substring, text)
+#     self.assertNotIn(substring, text
+#     self.assertRaises(e)
+#     self.assertRegexpMatches(text, pattern)
+#     self.assertNotRegexpMatches(text, pattern)
+#     self.tap("")
+
+class TestMetrics(TestCase):
+    def setUp(self):
+        self.t = Vramsteg()
+        self.directory = tempfile.mkdtemp()
+        self.path = os.path.join(self.directory, "job.prom")
+
+    def tearDown(self):
+        shutil.rmtree(self.directory)
+
+    def gauges(self):
+        """Reads the samples, keyed by metric name and label"""
+        samples = {}
+        with open(self.path) as f:
+            for line in f:
+                if not line.startswith("#"):
+                    key, value = line.rsplit(" ", 1)
+                    samples[key] = float(value)
+        return samples
+
+    def test_metrics_gauges(self):
+        """Verify that 'vramsteg --metrics-file' writes labelled gauges"""
+        self.t("--max 10 --current 4 --label build --metrics-file " + self.path)
+        samples = self.gauges()
+        self.assertEqual(samples['vramsteg_value{label="build"}'], 4)
+        self.assertEqual(samples['vramsteg_maximum{label="build"}'], 10)
+        self.assertEqual(samples['vramsteg_fraction{label="build"}'], 0.4)
+        self.assertEqual(samples['vramsteg_done{label="build"}'], 0)
+        self.assertIn('vramsteg_rate{label="build"}', samples)
+        self.assertIn('vramsteg_eta_seconds{label="build"}', samples)
+        self.assertEqual(os.listdir(self.directory), ["job.prom"])
+
+    def test_metrics_rate_limited(self):
+        """Verify that 'vramsteg --metrics-file' is written no more than once per interval"""
+        self.t("--max 10 --current 3 --metrics-file " + self.path)
+        self.t("--max 10 --current 4 --metrics-file " + self.path)
+        self.assertEqual(self.gauges()['vramsteg_value{label=""}'], 3)
+
+        self.t("--max 10 --current 5 --interval 0 --metrics-file " + self.path)
+        self.assertEqual(self.gauges()['vramsteg_value{label=""}'], 5)
+
+    def test_metrics_done(self):
+        """Verify that 'vramsteg --metrics-file' always writes a bar that is done"""
+        self.t("--stream --max 10 --interval 60 --metrics-file " + self.path, input="3\n10\n")
+        samples = self.gauges()
+        self.assertEqual(samples['vramsteg_value{label=""}'], 10)
+        self.assertEqual(samples['vramsteg_done{label=""}'], 1)
+
+    def test_metrics_maximum_rate_limited(self):
+        """Verify that 'vramsteg --metrics-file' rate limits updates at the maximum"""
+        self.t("--max 10 --current 9 --metrics-file " + self.path)
+        self.t("--max 10 --current 10 --metrics-file " + self.path)
+        self.assertEqual(self.gauges()['vramsteg_value{label=""}'], 9)
+
+        self.t("--max 10 --current 10 --interval 0 --metrics-file " + self.path)
+        samples = self.gauges()
+        self.assertEqual(samples['vramsteg_value{label=""}'], 10)
+        self.assertEqual(samples['vramsteg_done{label=""}'], 1)
+
+    def test_metrics_named_bars(self):
+        """Verify that 'vramsteg --stream --metrics-file' writes every named bar"""
+        self.t("--stream --max 10 --metrics-file " + self.path, input="a 1\nb 2\n")
+        samples = self.gauges()
+        self.assertEqual(samples['vramsteg_value{label="a"}'], 1)
+        self.assertEqual(samples['vramsteg_value{label="b"}'], 2)
+
+    def test_metrics_bad_path(self):
+        """Verify that 'vramsteg --metrics-file' reports a file it cannot write"""
+        code, out, err = self.t("--max 10 --current 3 --metrics-file /nonexistent/job.prom")
+        self.assertIn("The metrics file '/nonexistent/job.prom' could not be written:", err)
+
+    def test_metrics_bad_path_pipe(self):
+        """Verify that 'vramsteg --pipe --metrics-file' copies everything, although the file cannot be written"""
+        data = "x" * 300000
+        code, out, err = self.t("--pipe --max 300000 --interval 0 --metrics-file /nonexistent/job.prom", input=data)
+        self.assertEqual(out, data)
+        self.assertEqual(err.count("could not be written"), 1)
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+    unittest.main(testRunner=TAPTestRunner())
+
+# vim: ai sts=4 et sw=4 ft=python
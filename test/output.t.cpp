@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <Output.h>
+#include <Progress.h>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <test.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Fills the pipe until a write would block.
+static void fill (int fd)
+{
+  std::string block (4096, 'x');
+  while (write (fd, block.data (), block.size ()) > 0)
+    ;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reads everything in the pipe, returning the last byte.
+static char empty (int fd)
+{
+  char last = 0;
+  char buffer[4096];
+  ssize_t got;
+  while ((got = read (fd, buffer, sizeof (buffer))) > 0)
+    last = buffer[got - 1];
+
+  return last;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (9);
+
+  // A pipe that never blocks stands in for a slow terminal.
+  int ends[2];
+  if (pipe2 (ends, O_NONBLOCK) == -1)
+    return 1;
+
+  Output output;
+  t.ok (output.write (ends[1], "abc", 3),          "Output write sends to a ready descriptor");
+  t.notok (output.congested (),                    "Output is not congested after a whole write");
+
+  fill (ends[1]);
+  t.notok (output.write (ends[1], "abc", 3),       "Output write drops a frame that is not taken at all");
+  t.notok (output.congested (),                    "Output keeps nothing of a dropped frame");
+
+  // Freeing one page lets a larger frame in only in part.
+  char page[4096];
+  read (ends[0], page, sizeof (page));
+  std::string frame (3 * 4096, 'y');
+  frame.back () = 'z';
+  t.ok (output.write (ends[1], frame.data (), frame.size ()), "Output write keeps the rest of a partial frame");
+  t.ok (output.congested (),                       "Output is congested until the rest is sent");
+  t.notok (output.write (ends[1], "abc", 3),       "Output write refuses a new frame while congested");
+
+  empty (ends[0]);
+  t.ok (output.drain (ends[1]) && empty (ends[0]) == 'z', "Output drain completes the partial frame");
+
+  // A bar whose frame was dropped is owed one, which is composed in full.
+  Progress progress;
+  progress.maximum = 10;
+  progress.width = 20;
+  progress.refresh (5);
+  progress.dropped ();
+  t.ok (progress.pending () && progress.flush () && progress.frame ().size () >= 20,
+                                                   "Progress redraws a dropped frame in full");
+
+  close (ends[0]);
+  close (ends[1]);
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,103 @@
+#!/usr/bin/env python2.7
+# -*- coding: utf-8 -*-
+###############################################################################
+#
+# Copyright 2006 - 2017, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# http://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import sys
+import os
+import unittest
+import re
+import subprocess
+import tempfile
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Vramsteg, TestCase
+from basetest.utils import run_cmd_wait
+
+# Test methods available:
+#     self.assertEqual(a, b)
+#     self.assertNotEqual(a, b)
+#     self.assertTrue(x)
+#     self.assertFalse(x)
+#     self.assertIs(a, b)
+#     self.assertIsNot(substring, text)
+#     self.assertIsNone(x)
+#     self.assertIsNotNone(x)
+#     self.assertIn(substring, text)
+#     self.assertNotIn(substring, text
+#     self.assertRaises(e)
+#     self.assertRegexpMatches(text, pattern)
+#     self.assertNotRegexpMatches(text, pattern)
+#     self.tap("")
+
+READER = """
+import sys, time
+f = open(sys.argv[1], "rb")
+sys.stdout.write("ready\\n")
+sys.stdout.flush()
+while f.read(100000):
+    time.sleep(0.05)
+time.sleep(0.2)
+"""
+
+class TestPid(TestCase):
+    def setUp(self):
+        self.t = Vramsteg()
+        handle, self.path = tempfile.mkstemp()
+        os.write(handle, "x" * 1000000)
+        os.close(handle)
+
+    def tearDown(self):
+        os.remove(self.path)
+
+    def test_pid_follows_largest_file(self):
+        """Verify that 'vramsteg --pid' follows the largest file a process reads"""
+        reader = subprocess.Popen([sys.executable, "-c", READER, self.path],
+                                  stdout=subprocess.PIPE)
+        reader.stdout.readline()
+        code, out, err = self.t("--pid %d --events - --interval 0" % reader.pid)
+        reader.wait()
+        self.assertIn('"maximum":1000000,', out)
+        self.assertIn('"value":1000000,', out)
+        self.assertIn('"done":true}', out)
+
+    def test_pid_missing_fd(self):
+        """Verify that 'vramsteg --pid --fd' rejects a descriptor that is not open"""
+        code, out, err = self.t("--pid %d --fd 999" % os.getpid())
+        self.assertIn("Process %d has no file descriptor 999." % os.getpid(), err)
+
+    def test_fd_needs_pid(self):
+        """Verify that 'vramsteg --fd' requires --pid"""
+        code, out, err = self.t("--fd 3 --max 10")
+        self.assertIn("To use the --fd feature, --pid must be provided.", err)
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+    unittest.main(testRunner=TAPTestRunner())
+
+# vim: ai sts=4 et sw=4 ft=python
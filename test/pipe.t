@@ -0,0 +1,136 @@
+#!/usr/bin/env python2.7
+# -*- coding: utf-8 -*-
+###############################################################################
+#
+# Copyright 2006 - 2017, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# http://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import sys
+import os
+import unittest
+import re
+import subprocess
+import tempfile
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Vramsteg, TestCase
+from basetest.utils import run_cmd_wait
+
+# Test methods available:
+#     self.assertEqual(a, b)
+#     self.assertNotEqual(a, b)
+#     self.assertTrue(x)
+#     self.assertFalse(x)
+#     self.assertIs(a, b)
+#     self.assertIsNot(substring, text)
+#     self.assertIsNone(x)
+#     self.assertIsNotNone(x)
+#     self.assertIn(substring, text)
+#     self.assertNotIn(substring, text
+#     self.assertRaises(e)
+#     self.assertRegexpMatches(text, pattern)
+#     self.assertNotRegexpMatches(text, pattern)
+#     self.tap("")
+
+class TestPipe(TestCase):
+    def setUp(self):
+        self.t = Vramsteg()
+
+    def test_pipe_copies_data(self):
+        """Verify that 'vramsteg --pipe' copies stdin to stdout unchanged"""
+        data = "".join(chr(i % 256) for i in range(300000))
+        code, out, err = self.t("--pipe --max 300000", input=data)
+        self.assertEqual(len(out), len(data))
+        self.assertEqual(out, data)
+        self.assertNotIn("Error", err)
+
+    def test_pipe_beyond_max(self):
+        """Verify that 'vramsteg --pipe' copies more data than --max"""
+        code, out, err = self.t("--pipe --max 10", input="x" * 1000)
+        self.assertEqual(out, "x" * 1000)
+
+    def test_pipe_empty(self):
+        """Verify that 'vramsteg --pipe' handles empty input"""
+        code, out, err = self.t("--pipe --max 10", input="")
+        self.assertEqual(out, "")
+        self.assertNotIn("Error", err)
+
+    def test_lines_copies_data(self):
+        """Verify that 'vramsteg --lines' copies stdin to stdout, counting lines"""
+        data = "".join("line %d\n" % i for i in range(100000))
+        code, out, err = self.t("--lines --max 100000 --events /dev/stderr --interval 60", input=data)
+        self.assertEqual(out, data)
+        self.assertIn('"value":100000,', err)
+
+    def test_lines_last_line(self):
+        """Verify that 'vramsteg --lines' counts a last line without a newline"""
+        code, out, err = self.t("--lines --max 3 --events /dev/stderr", input="a\nb\nc")
+        self.assertEqual(out, "a\nb\nc")
+        self.assertIn('"value":3,', err)
+
+    def broken(self, args, output):
+        """Copies 4MB through 'vramsteg', into output, which is closed after
+        reading a byte if it is a pipe, and returns the exit code and stderr"""
+        with tempfile.TemporaryFile() as data:
+            data.write("line\n" * 800000)
+            data.seek(0)
+            p = subprocess.Popen([self.t.vramsteg] + args.split(), env=self.t.env, stdin=data,
+                                 stdout=output, stderr=subprocess.PIPE)
+            if output == subprocess.PIPE:
+                p.stdout.read(1)
+                p.stdout.close()
+            err = p.stderr.read()
+            return p.wait(), err
+
+    def test_pipe_output_closed(self):
+        """Verify that 'vramsteg --pipe' fails when its output is closed early"""
+        code, err = self.broken("--pipe --max 4000000", subprocess.PIPE)
+        self.assertEqual(code, 1)
+        self.assertIn("Error: The output was closed before all of the input was copied.", err)
+
+    def test_lines_output_closed(self):
+        """Verify that 'vramsteg --lines' fails when its output is closed early"""
+        code, err = self.broken("--lines --max 800000", subprocess.PIPE)
+        self.assertEqual(code, 1)
+        self.assertIn("Error: The output was closed before all of the input was copied.", err)
+
+    def test_pipe_output_full(self):
+        """Verify that 'vramsteg --pipe' fails when its output cannot be written"""
+        with open("/dev/full", "w") as full:
+            code, err = self.broken("--pipe --max 4000000", full)
+        self.assertEqual(code, 1)
+        self.assertIn("Error: Could not write output: No space left on device", err)
+
+    def test_pipe_and_stream(self):
+        """Verify that 'vramsteg --pipe --stream' is rejected"""
+        code, out, err = self.t("--pipe --stream --max 10", input="")
+        self.assertIn("Only one of the --stream, --pipe, --shm, --watch-file and --pid features, or run, can be used.", err)
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+    unittest.main(testRunner=TAPTestRunner())
+
+# vim: ai sts=4 et sw=4 ft=python
@@ -0,0 +1,190 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <Progress.h>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <ctime>
+#include <test.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// The text of a frame, without control sequences.  Only a full repaint shows the
+// whole line.
+static std::string visible (const Progress& progress)
+{
+  std::string bytes (progress.frame ().data (), progress.frame ().size ());
+  std::string text;
+  for (size_t i = 0; i < bytes.length (); ++i)
+  {
+    if (bytes[i] == '\033')
+      i = bytes.find_first_of ("Cm", i);
+    else if (bytes[i] != '\r')
+      text += bytes[i];
+  }
+
+  return text;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Applies a frame to the line a terminal would show.  Frames after the first
+// only rewrite the cells that changed, and skip the others.
+static void apply (std::string& line, const Progress& progress)
+{
+  std::string bytes (progress.frame ().data (), progress.frame ().size ());
+  size_t column = 0;
+  for (size_t i = 0; i < bytes.length (); ++i)
+  {
+    if (bytes[i] == '\033')
+    {
+      auto end = bytes.find_first_of ("Cm", i);
+      if (bytes[end] == 'C')
+        column += atoi (bytes.c_str () + i + 2);
+      i = end;
+    }
+    else if (bytes[i] == '\r')
+      column = 0;
+    else
+    {
+      if (line.length () <= column)
+        line.resize (column + 1, ' ');
+      line[column++] = bytes[i];
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The number in the rate field.
+static double rate (const std::string& line)
+{
+  auto end = line.find ("/s");
+  auto begin = line.rfind (' ', end);
+  return atof (line.substr (begin + 1, end - begin - 1).c_str ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void prepare (Progress& progress)
+{
+  progress.style   = "text";
+  progress.width   = 60;
+  progress.maximum = 1000;
+  progress.rate    = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (14);
+
+  // Before there are two samples, the rate is the average since the start.
+  Progress average;
+  prepare (average);
+  average.start = time (nullptr) - 10;
+  average.refresh (500);
+  auto line = visible (average);
+  t.ok (rate (line) > 45.0 && rate (line) <= 50.0,  "Rate is the average since the start: " + line);
+  t.is (line.length (), (size_t) 60,                 "Rate field fits the width");
+
+  Progress idle;
+  prepare (idle);
+  idle.refresh (0);
+  t.is (visible (idle).length (), (size_t) 60,       "Rate field has a constant width");
+  t.ok (visible (idle).find (" 0.0/s") != std::string::npos,
+                                                     "Rate without a start time is zero");
+
+  // Bytes are shown with binary prefixes.
+  Progress bytes;
+  prepare (bytes);
+  bytes.bytes   = true;
+  bytes.maximum = 1L << 40;
+  bytes.start   = time (nullptr) - 10;
+  bytes.refresh (50L << 20);
+  line = visible (bytes);
+  t.ok (line.find ("MiB/s") != std::string::npos,    "Byte rate uses binary prefixes: " + line);
+  t.is (line.length (), (size_t) 60,                 "Byte rate field fits the width");
+
+  // Successive updates give a measured rate, which then drives the estimate,
+  // instead of the average since a start time long ago.
+  Progress measured;
+  prepare (measured);
+  measured.estimate = true;
+  measured.start    = time (nullptr) - 1000;
+  measured.refresh (0);
+  std::this_thread::sleep_for (std::chrono::milliseconds (200));
+  measured.invalidate ();
+  measured.refresh (100);
+  line = visible (measured);
+  t.ok (rate (line) > 250.0 && rate (line) <= 500.0, "Rate is measured between updates: " + line);
+  t.ok (line.substr (line.length () - 5, 4) == "00:0",
+                                                     "Estimate uses the measured rate: " + line);
+
+  // A value that changes nothing visible composes no frame, so nothing is
+  // written.
+  Progress same;
+  same.style   = "text";
+  same.width   = 24;
+  same.maximum = 1000;
+  t.ok (same.refresh (500),                          "A new value composes a frame");
+  t.notok (same.refresh (500),                       "The same value composes no frame");
+  t.notok (same.refresh (501),                       "A value that changes nothing visible composes no frame");
+
+  // A burst of updates composes no more than fps frames per second, but the
+  // last value is still drawn, by flush for a frame held back.
+  Progress burst;
+  burst.style   = "text";
+  burst.width   = 24;
+  burst.maximum = 1000;
+  burst.fps     = 10;
+  std::string screen;
+  auto frames = 0;
+  auto begin = std::chrono::steady_clock::now ();
+  for (long value = 1; value < 1000; ++value)
+  {
+    if (burst.refresh (value))
+    {
+      ++frames;
+      apply (screen, burst);
+    }
+  }
+
+  auto seconds = std::chrono::duration <double> (std::chrono::steady_clock::now () - begin).count ();
+  t.ok (frames <= 10 * seconds + 1,                  "A burst composes no more than fps frames a second: " + std::to_string (frames));
+  t.ok (burst.pending () && burst.flush (),          "The last value of a burst is held back, not lost");
+
+  Progress last;
+  last.style   = "text";
+  last.width   = 24;
+  last.maximum = 1000;
+  last.refresh (999);
+  apply (screen, burst);
+  t.is (screen, visible (last),                      "The held back frame shows the last value");
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,78 @@
+#!/usr/bin/env python2.7
+# -*- coding: utf-8 -*-
+###############################################################################
+#
+# Copyright 2006 - 2017, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# http://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import sys
+import os
+import unittest
+import re
+import subprocess
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Vramsteg, Screen, TestCase
+
+# Test methods available:
+#     self.assertEqual(a, b)
+#     self.assertNotEqual(a, b)
+#     self.assertTrue(x)
+#     self.assertFalse(x)
+#     self.assertIs(a, b)
+#     self.assertIsNot(substring, text)
+#     self.assertIsNone(x)
+#     self.assertIsNotNone(x)
+#     self.assertIn(substring, text)
+#     self.assertNotIn(substring, text
+#     self.assertRaises(e)
+#     self.assertRegexpMatches(text, pattern)
+
+class TestRender(TestCase):
+    def setUp(self):
+        self.t = Vramsteg()
+
+    def test_render_bar(self):
+        """Verify that 'vramsteg' draws the bar, and leaves the cursor at its start"""
+        screen = Screen().feed(self.t.tty("--style text --min 0 --max 10 --current 5 --width 20 --percentage"))
+        self.assertEqual(screen.text(), "[******       ]  50%")
+        self.assertEqual((screen.row, screen.column), (0, 0))
+
+    def test_render_remove(self):
+        """Verify that 'vramsteg --remove' blanks a bar drawn by an earlier invocation"""
+        screen = Screen().feed(self.t.tty("--style text --min 0 --max 10 --current 5 --width 20"))
+        self.assertNotEqual(screen.text(), "")
+        out = self.t.tty("--remove --width 20")
+        self.assertEqual(out, "\r" + " " * 20 + "\r\r\n")
+        screen.feed(out)
+        self.assertEqual(screen.text(), "")
+        self.assertEqual((screen.row, screen.column), (1, 0))
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+    unittest.main(testRunner=TAPTestRunner())
+
+# vim: ai sts=4 et sw=4 ft=python
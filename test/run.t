@@ -0,0 +1,106 @@
+#!/usr/bin/env python2.7
+# -*- coding: utf-8 -*-
+###############################################################################
+#
+# Copyright 2006 - 2017, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# http://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import sys
+import os
+import unittest
+import json
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Vramsteg, Screen, TestCase
+
+# Test methods available:
+#     self.assertEqual(a, b)
+#     self.assertNotEqual(a, b)
+#     self.assertTrue(x)
+#     self.assertFalse(x)
+#     self.assertIs(a, b)
+#     self.assertIsNot(substring, text)
+#     self.assertIsNone(x)
+#     self.assertIsNotNone(x)
+#     self.assertIn(substring, text)
+#     self.assertNotIn(substring, text
+#     self.assertRaises(e)
+#     self.assertRegexpMatches(text, pattern)
+#     self.assertNotRegexpMatches(text, pattern)
+#     self.tap("")
+
+class TestRun(TestCase):
+    def setUp(self):
+        self.t = Vramsteg()
+
+    def test_run_substitutes_items(self):
+        """Verify that 'vramsteg run' runs the command once per item"""
+        code, out, err = self.t("run -j 3 --max 5 -- echo item {}", input="1\n2\n\n3\n4\n5")
+        self.assertEqual(sorted(out.splitlines()), ["item %d" % i for i in range(1, 6)])
+        self.assertNotIn("Error", err)
+
+    def test_run_appends_items(self):
+        """Verify that 'vramsteg run' appends the item when there is no {}"""
+        code, out, err = self.t("run -j 1 --max 2 -- echo item", input="a\nb\n")
+        self.assertEqual(out, "item a\nitem b\n")
+
+    def test_run_counts_completed(self):
+        """Verify that 'vramsteg run' advances the bar once per completed command"""
+        code, out, err = self.t("run -j 2 --max 4 --events /dev/stderr --interval 0 -- true",
+                                input="1\n2\n3\n4\n")
+        events = [json.loads(line) for line in err.splitlines()]
+        self.assertEqual(events[-1]["value"], 4)
+        self.assertTrue(events[-1]["done"])
+
+    def test_run_reports_failures(self):
+        """Verify that 'vramsteg run' exits non-zero when a command fails"""
+        code, out, err = self.t.runError("run -j 2 --max 3 -- sh -c 'exit $0' {}", input="0\n1\n2\n")
+        self.assertIn("Error: 2 of the commands failed.", err)
+
+    def test_run_leaves_no_blank_lines(self):
+        """Verify that 'vramsteg run' ends on the line after the bar, whatever the number of workers"""
+        screen = Screen().feed(self.t.tty("run -j 8 --max 4 --style text --width 20 --percentage -- echo item {}",
+                                          input="1\n2\n3\n4\n"))
+        lines = screen.lines()
+        self.assertEqual(sorted(lines[:4]), ["item %d" % i for i in range(1, 5)])
+        self.assertEqual(lines[4], "[*************] 100%")
+        self.assertEqual((screen.row, screen.column), (5, 0))
+
+        screen = Screen().feed(self.t.tty("run -j 8 --max 4 --style text --width 20 --percentage -- true",
+                                          input="1\n2\n3\n4\n"))
+        self.assertEqual(screen.text(), "[*************] 100%")
+        self.assertEqual((screen.row, screen.column), (1, 0))
+
+    def test_run_needs_command(self):
+        """Verify that 'vramsteg run' requires a command"""
+        code, out, err = self.t("run --max 3")
+        self.assertIn("To use the run command, a command must follow its options.", err)
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+    unittest.main(testRunner=TAPTestRunner())
+
+# vim: ai sts=4 et sw=4 ft=python
@@ -0,0 +1,111 @@
+#!/usr/bin/env python2.7
+# -*- coding: utf-8 -*-
+###############################################################################
+#
+# Copyright 2006 - 2017, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# http://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import sys
+import os
+import unittest
+import re
+import signal
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Vramsteg, Screen, TestCase
+from basetest.utils import run_cmd_wait
+
+# Test methods available:
+#     self.assertEqual(a, b)
+#     self.assertNotEqual(a, b)
+#     self.assertTrue(x)
+#     self.assertFalse(x)
+#     self.assertIs(a, b)
+#     self.assertIsNot(substring, text)
+#     self.assertIsNone(x)
+#     self.assertIsNotNone(x)
+#     self.assertIn(substring, text)
+#     self.assertNotIn(substring, text
+#     self.assertRaises(e)
+#     self.assertRegexpMatches(text, pattern)
+#     self.assertNotRegexpMatches(text, pattern)
+#     self.tap("")
+
+class TestShm(TestCase):
+    def setUp(self):
+        self.t = Vramsteg()
+        self.name = "test-%d" % os.getpid()
+
+    def tearDown(self):
+        if os.path.exists("/dev/shm/vramsteg-" + self.name):
+            os.remove("/dev/shm/vramsteg-" + self.name)
+
+    def test_shm_add_and_display(self):
+        """Verify that 'vramsteg --shm' exits once added values reach --max"""
+        self.t("--shm %s --init --max 6" % self.name)
+        for i in range(3):
+            code, out, err = self.t("--shm %s --add 2" % self.name)
+            self.assertEqual(err, "")
+        code, out, err = self.t("--shm %s" % self.name)
+        self.assertNotIn("Error", err)
+        self.assertFalse(os.path.exists("/dev/shm/vramsteg-" + self.name))
+
+    def test_shm_interrupted(self):
+        """Verify that 'vramsteg --shm' finishes its line on an interrupt, and keeps the counter"""
+        self.t("--shm %s --init --max 10" % self.name)
+        self.t("--shm %s --add 3" % self.name)
+        out = self.t.tty("--shm %s --style text --width 20 --percentage" % self.name,
+                         delay=0.5, signal=signal.SIGINT)
+        screen = Screen().feed(out)
+        self.assertEqual(screen.lines(), ["[***          ]  30%", ""])
+        self.assertTrue(os.path.exists("/dev/shm/vramsteg-" + self.name))
+
+    def test_shm_unsized(self):
+        """Verify that 'vramsteg --shm' rejects a counter that is not sized yet"""
+        open("/dev/shm/vramsteg-" + self.name, "w").close()
+        code, out, err = self.t("--shm %s" % self.name)
+        self.assertIn("The shared counter '%s' is not initialized." % self.name, err)
+
+    def test_shm_missing(self):
+        """Verify that 'vramsteg --shm' reports a missing counter"""
+        code, out, err = self.t("--shm %s --add 1" % self.name)
+        self.assertIn("The shared counter '%s' does not exist." % self.name, err)
+
+    def test_shm_init_needs_max(self):
+        """Verify that 'vramsteg --shm --init' requires --max"""
+        code, out, err = self.t("--shm %s --init" % self.name)
+        self.assertIn("To use the --init feature, --max must be provided.", err)
+
+    def test_add_needs_shm(self):
+        """Verify that 'vramsteg --add' requires --shm"""
+        code, out, err = self.t("--add 1")
+        self.assertIn("To use the --init or --add features, --shm must be provided.", err)
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+    unittest.main(testRunner=TAPTestRunner())
+
+# vim: ai sts=4 et sw=4 ft=python
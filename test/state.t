@@ -0,0 +1,100 @@
+#!/usr/bin/env python2.7
+# -*- coding: utf-8 -*-
+###############################################################################
+#
+# Copyright 2006 - 2017, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# http://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import sys
+import os
+import unittest
+import re
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Vramsteg, TestCase
+from basetest.utils import run_cmd_wait
+
+# Test methods available:
+#     self.assertEqual(a, b)
+#     self.assertNotEqual(a, b)
+#     self.assertTrue(x)
+#     self.assertFalse(x)
+#     self.assertIs(a, b)
+#     self.assertIsNot(substring, text)
+#     self.assertIsNone(x)
+#     self.assertIsNotNone(x)
+#     self.assertIn(substring, text)
+#     self.assertNotIn(substring, text
+#     self.assertRaises(e)
+#     self.assertRegexpMatches(text, pattern)
+#     self.assertNotRegexpMatches(text, pattern)
+#     self.tap("")
+
+class TestState(TestCase):
+    def setUp(self):
+        self.t = Vramsteg()
+        self.state = os.path.join(self.t.datadir, "state")
+
+    def test_state_remembers_range(self):
+        """Verify that 'vramsteg --state' remembers --min and --max"""
+        code, out, err = self.t("--state %s --min 0 --max 100 --current 5" % self.state)
+        self.assertTrue(os.path.exists(self.state))
+        code, out, err = self.t("--state %s --current 50" % self.state)
+        self.assertEqual(err, "")
+        code, out, err = self.t("--state %s --current 500" % self.state)
+        self.assertIn("The --current value must not lie outside the --min/--max range.", err)
+
+    def test_state_skips_unchanged_frame(self):
+        """Verify that 'vramsteg --state' draws nothing when the bar would not change"""
+        first = self.t.tty("--state %s --max 1000 --current 1 --width 40 --percentage" % self.state)
+        self.assertIn("0%", first)
+        self.assertEqual(self.t.tty("--state %s --current 2 --width 40 --percentage" % self.state), "")
+        self.assertIn("1%", self.t.tty("--state %s --current 10 --width 40 --percentage" % self.state))
+
+    def test_state_reports_unchanged_frame(self):
+        """Verify that 'vramsteg --state' reports a new value whose frame would not change"""
+        self.t.tty("--state %s --max 1000 --current 1 --width 40 --percentage" % self.state)
+        code, out, err = self.t("--state %s --current 2 --width 40 --percentage --events /dev/stderr" % self.state)
+        self.assertIn('"value":2,', err)
+        code, out, err = self.t("--state %s --current 3 --width 40 --percentage --events /dev/stderr" % self.state)
+        self.assertIn('"value":3,', err)
+
+    def test_state_removed(self):
+        """Verify that 'vramsteg --state --remove' deletes the state file"""
+        self.t("--state %s --max 10 --current 1" % self.state)
+        self.t("--state %s --remove" % self.state)
+        self.assertFalse(os.path.exists(self.state))
+
+    def test_state_and_stream(self):
+        """Verify that 'vramsteg --state --stream' is rejected"""
+        code, out, err = self.t("--state %s --stream --max 10" % self.state, input="")
+        self.assertIn("The --state feature cannot be combined with --stream, --pipe, --shm, --watch-file, --pid or run.", err)
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+    unittest.main(testRunner=TAPTestRunner())
+
+# vim: ai sts=4 et sw=4 ft=python
@@ -0,0 +1,158 @@
+#!/usr/bin/env python2.7
+# -*- coding: utf-8 -*-
+###############################################################################
+#
+# Copyright 2006 - 2017, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# http://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import sys
+import os
+import unittest
+import re
+import signal
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Vramsteg, Screen, TestCase
+from basetest.utils import run_cmd_wait
+
+# Test methods available:
+#     self.assertEqual(a, b)
+#     self.assertNotEqual(a, b)
+#     self.assertTrue(x)
+#     self.assertFalse(x)
+#     self.assertIs(a, b)
+#     self.assertIsNot(substring, text)
+#     self.assertIsNone(x)
+#     self.assertIsNotNone(x)
+#     self.assertIn(substring, text)
+#     self.assertNotIn(substring, text
+#     self.assertRaises(e)
+#     self.assertRegexpMatches(text, pattern)
+#     self.assertNotRegexpMatches(text, pattern)
+#     self.tap("")
+
+class TestStream(TestCase):
+    def setUp(self):
+        self.t = Vramsteg()
+
+    def test_stream_values(self):
+        """Verify that 'vramsteg --stream' consumes values until end of input"""
+        code, out, err = self.t("--stream --min 0 --max 10", input="0\n5\n\n10\n")
+        self.assertNotIn("Error", err)
+
+    def test_stream_without_start(self):
+        """Verify that 'vramsteg --stream --elapsed' does not need --start"""
+        code, out, err = self.t("--stream --max 10 --elapsed --estimate", input="1\n")
+        self.assertNotIn("Error", err)
+
+    def test_stream_bad_value(self):
+        """Verify that 'vramsteg --stream' rejects a non-integer value"""
+        code, out, err = self.t("--stream --min 0 --max 10", input="1\nfoo\n")
+        self.assertIn("The value 'foo' is not an integer.", err)
+
+    def test_stream_negative_fps(self):
+        """Verify that 'vramsteg --fps' rejects a negative frame rate"""
+        code, out, err = self.t("--stream --max 10 --fps -1", input="1\n")
+        self.assertIn("The --fps value must not be negative.", err)
+
+    def test_stream_named_bars(self):
+        """Verify that 'vramsteg --stream' accepts named bars"""
+        code, out, err = self.t("--stream --max 10 --remove",
+                                input="shard1 1\nshard2 4\nshard1 10\nshard1 done\nshard2 7\n")
+        self.assertNotIn("Error", err)
+
+    def test_stream_named_bars_drawn(self):
+        """Verify that 'vramsteg --stream' draws named bars on their own lines, with labels lined up"""
+        screen = Screen().feed(self.t.tty("--stream --max 10 --style text --width 24 --percentage",
+                                          input="a 1\nbb 4\na 10\nbb 7\n"))
+        self.assertEqual(screen.lines(), ["a  [**************] 100%",
+                                          "bb [*********     ]  70%",
+                                          ""])
+        self.assertEqual((screen.row, screen.column), (2, 0))
+
+    def test_stream_named_bars_removed(self):
+        """Verify that 'vramsteg --stream --remove' moves the bars below a finished bar up"""
+        out = self.t.tty("--stream --max 10 --style text --width 24 --percentage --remove",
+                         input="a 1\nbb 4\nc 2\na 10\na done\nbb 7\n")
+        screens = Screen().history(out)
+        self.assertIn("bb [*********     ]  70%\n"
+                      "c  [**            ]  20%", screens)
+        self.assertEqual(screens[-1], "")
+
+    def test_stream_named_bad_value(self):
+        """Verify that 'vramsteg --stream' rejects a named non-integer value"""
+        code, out, err = self.t("--stream --max 10", input="shard1 foo\n")
+        self.assertIn("The value 'foo' is not an integer.", err)
+
+    def test_stream_drawn(self):
+        """Verify that 'vramsteg --stream' ends with the final frame, on the line after it"""
+        screen = Screen().feed(self.t.tty("--stream --max 100 --style text --width 20 --percentage",
+                                          input="0\n50\n100\n"))
+        self.assertEqual(screen.lines(), ["[*************] 100%", ""])
+        self.assertEqual((screen.row, screen.column), (1, 0))
+
+    def test_stream_interrupted(self):
+        """Verify that 'vramsteg --stream' finishes its line on an interrupt"""
+        screen = Screen().feed(self.t.tty("--stream --max 100 --style text --width 20 --percentage",
+                                          input="30\n", delay=0.5, signal=signal.SIGINT))
+        self.assertEqual(screen.lines(), ["[***          ]  30%", ""])
+
+    def test_stream_idle_ticks(self):
+        """Verify that 'vramsteg --stream --elapsed' redraws while input is idle"""
+        out = self.t.tty("--stream --max 100 --width 40 --elapsed", "10\n", 1.5)
+        # The first frame shows 00:00, and a later one changes only the last digit.
+        self.assertIn("00:00", out)
+        self.assertRegexpMatches(out, "\x1b\\[\\d+C1\r")
+
+    def test_stream_coalesced(self):
+        """Verify that 'vramsteg --stream' draws values arriving together once"""
+        out = self.t.tty("--stream --max 100 --width 40 --percentage",
+                       "".join("%d\n" % i for i in range(0, 101, 10)))
+        self.assertEqual(out.count("%"), 1)
+        self.assertIn("100%", out)
+
+    def test_stream_deltas(self):
+        """Verify that 'vramsteg --stream' adds values with a leading '+'"""
+        out = self.t.tty("--stream --max 100 --width 40 --percentage",
+                       "a 30\na +30\na +10\n")
+        self.assertIn(" 70%", out)
+
+    def test_steps_needs_long_running_mode(self):
+        """Verify that 'vramsteg --steps' is rejected for a single update"""
+        code, out, err = self.t("--max 10 --current 3 --steps")
+        self.assertIn("The --steps feature needs --stream, --pipe, --shm, --watch-file, --pid or run.", err)
+        code, out, err = self.t("--max 10 --current 3 --format '{bar} {p50}'")
+        self.assertIn("The {min}, {avg}, {p50} and {p99} format fields need", err)
+
+    def test_stream_bad_delta(self):
+        """Verify that 'vramsteg --stream' rejects a non-integer delta"""
+        code, out, err = self.t("--stream --max 10", input="+-x\n")
+        self.assertIn("The value '+-x' is not an integer.", err)
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+    unittest.main(testRunner=TAPTestRunner())
+
+# vim: ai sts=4 et sw=4 ft=python
@@ -0,0 +1,134 @@
+#!/usr/bin/env python2.7
+# -*- coding: utf-8 -*-
+###############################################################################
+#
+# Copyright 2006 - 2017, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# http://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import sys
+import os
+import unittest
+import json
+import time
+import shutil
+import tempfile
+import subprocess
+import resource
+import signal
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Vramsteg, TestCase
+
+# Test methods available:
+#     self.assertEqual(a, b)
+#     self.assertNotEqual(a, b)
+#     self.assertTrue(x)
+#     self.assertFalse(x)
+#     self.assertIs(a, b)
+#     self.assertIsNot(substring, text)
+#     self.assertIsNone(x)
+#     self.assertIsNotNone(x)
+#     self.assertIn(substring, text)
+#     self.assertNotIn(substring, text
+#     self.assertRaises(e)
+#     self.assertRegexpMatches(text, pattern)
+#     self.assertNotRegexpMatches(text, pattern)
+#     self.tap("")
+
+class TestTrace(TestCase):
+    def setUp(self):
+        self.t = Vramsteg()
+        self.directory = tempfile.mkdtemp()
+        self.path = os.path.join(self.directory, "trace.json")
+
+    def tearDown(self):
+        shutil.rmtree(self.directory)
+
+    def events(self, phase):
+        with open(self.path) as f:
+            trace = json.load(f)
+        return [e for e in trace["traceEvents"] if e["ph"] == phase]
+
+    def test_trace_stream(self):
+        """Verify that 'vramsteg --trace' records every update as a counter"""
+        p = subprocess.Popen([self.t.vramsteg, "--stream", "--max", "10", "--label", "load",
+                              "--trace", self.path], stdin=subprocess.PIPE)
+        for value in [2, 5, 10]:
+            p.stdin.write("%d\n" % value)
+            p.stdin.flush()
+            time.sleep(0.05)
+        p.communicate()
+
+        counters = self.events("C")
+        self.assertEqual([e["args"]["value"] for e in counters], [2, 5, 10, 10])
+        self.assertEqual(set(e["name"] for e in counters), set(["load"]))
+        times = [e["ts"] for e in counters]
+        self.assertEqual(times, sorted(times))
+
+        slices = self.events("X")
+        self.assertEqual(len(slices), 1)
+        self.assertEqual(slices[0]["args"], {"minimum": 0, "maximum": 10})
+        self.assertEqual(os.listdir(self.directory), ["trace.json"])
+
+    def test_trace_pipe(self):
+        """Verify that 'vramsteg --pipe --trace' records the bytes copied"""
+        code, out, err = self.t("--pipe --max 300000 --trace " + self.path, input="x" * 300000)
+        counters = self.events("C")
+        self.assertEqual(counters[-1]["args"]["value"], 300000)
+
+    def test_trace_escapes_names(self):
+        """Verify that 'vramsteg --trace' escapes bar names as --events does"""
+        code, out, err = self.t("--stream --max 10 --events - --trace " + self.path,
+                                input='x "y"\\z 4\n')
+        self.assertEqual(json.loads(out.splitlines()[-1])["label"], 'x "y"\\z')
+        self.assertEqual(set(e["name"] for e in self.events("C")), set(['x "y"\\z']))
+
+    def test_trace_log_full(self):
+        """Verify that 'vramsteg --trace' carries on when its log cannot be written"""
+        def limit():
+            # Files may not grow beyond the first 64KiB chunk of the log.
+            signal.signal(signal.SIGXFSZ, signal.SIG_IGN)
+            resource.setrlimit(resource.RLIMIT_FSIZE, (100000, 100000))
+
+        p = subprocess.Popen([self.t.vramsteg, "--stream", "--max", "10", "--events", "-",
+                              "--trace", self.path],
+                             stdin=subprocess.PIPE, stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                             preexec_fn=limit)
+        out, err = p.communicate("".join("bar%d 1\n" % i for i in range(6000)))
+        self.assertEqual(p.returncode, 0)
+        self.assertEqual(err.count("The trace log could not be written"), 1)
+        self.assertIn('"label":"bar5999"', out)
+
+    def test_trace_needs_long_running_mode(self):
+        """Verify that 'vramsteg --trace' is rejected for a single update"""
+        code, out, err = self.t("--max 10 --current 3 --trace " + self.path)
+        self.assertIn("The --trace feature needs --stream, --pipe, --shm, --watch-file, --pid or run.", err)
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+    unittest.main(testRunner=TAPTestRunner())
+
+# vim: ai sts=4 et sw=4 ft=python
@@ -0,0 +1,247 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2010 - 2017, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <Tracker.h>
+#include <algorithm>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <cerrno>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include <test.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// The bar is only drawn on a terminal, so the tests draw on a raw
+// pseudo-terminal, and read what is drawn from its master side.
+static int openTerminal (int& master)
+{
+  master = posix_openpt (O_RDWR | O_NOCTTY);
+  grantpt (master);
+  unlockpt (master);
+  auto terminal = open (ptsname (master), O_WRONLY | O_NOCTTY);
+
+  struct termios settings;
+  tcgetattr (terminal, &settings);
+  cfmakeraw (&settings);
+  tcsetattr (terminal, TCSANOW, &settings);
+  return terminal;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Collects everything drawn, until the end marker that closeTerminal writes.
+// Closing the terminal instead could lose output still in transit.
+static std::thread readTerminal (int master, std::string& drawn)
+{
+  return std::thread ([master, &drawn]
+  {
+    char buffer[4096];
+    ssize_t length;
+    while (drawn.empty () || drawn.back () != '\004')
+      if ((length = read (master, buffer, sizeof (buffer))) > 0)
+        drawn.append (buffer, length);
+      else if (length == -1 && errno != EINTR)
+        break;
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void closeTerminal (int terminal, int master, std::thread& reader)
+{
+  write (terminal, "\004", 1);
+  reader.join ();
+  close (terminal);
+  close (master);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The last line left on the screen.  Frames only rewrite the cells that
+// changed, so the bytes are applied to a line, rather than searched.
+static std::string lastLine (const std::string& drawn)
+{
+  std::string line;
+  std::string last;
+  size_t column = 0;
+  for (size_t i = 0; i < drawn.size (); ++i)
+  {
+    auto c = drawn[i];
+    if (c == '\033')
+    {
+      auto end = drawn.find_first_of ("ABCDHJKm", i);
+      if (drawn[end] == 'C')
+        column += atoi (drawn.c_str () + i + 2);
+      else if (drawn[end] == 'K')
+        line.erase (std::min (column, line.size ()));
+      i = end;
+    }
+    else if (c == '\r')
+      column = 0;
+    else if (c == '\n')
+    {
+      if (line.find_first_not_of (' ') != std::string::npos)
+        last = line;
+      line.clear ();
+      column = 0;
+    }
+    else
+    {
+      if (line.size () <= column)
+        line.resize (column + 1, ' ');
+      line[column++] = c;
+    }
+  }
+
+  return last;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Each frame ends by returning to the start of the line.
+static int frames (const std::string& drawn)
+{
+  int count = 0;
+  for (auto c : drawn)
+    if (c == '\r')
+      ++count;
+
+  return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (9);
+
+  Progress progress;
+  progress.maximum = 400000;
+  progress.fps = 5;
+  progress.fd = open ("/dev/null", O_WRONLY);
+
+  // Many threads advancing concurrently lose no updates.
+  Tracker tracker (progress);
+  t.is ((int) tracker.value (), 0,                "Tracker starts at the minimum");
+
+  std::vector <std::thread> workers;
+  for (int i = 0; i < 8; ++i)
+    workers.push_back (std::thread ([&tracker]
+    {
+      for (int j = 0; j < 50000; ++j)
+        tracker.advance (1);
+    }));
+
+  for (auto& worker : workers)
+    worker.join ();
+
+  t.is ((int) tracker.value (), 400000,           "Tracker counts every advance from 8 threads");
+
+  tracker.set (17);
+  t.is ((int) tracker.value (), 17,               "Tracker set replaces the value");
+
+  // Stopping twice is harmless, and restores the frame rate setting.
+  tracker.stop ();
+  tracker.stop ();
+  t.is (progress.fps, 5,                          "Tracker stop leaves the Progress settings alone");
+
+  // On a terminal, the bar is sampled at the fps setting however often the
+  // value changes, and the final value is drawn.
+  int master;
+  std::string drawn;
+  Progress sampled;
+  sampled.maximum = 1000;
+  sampled.remove = false;
+  sampled.fps = 10;
+  sampled.fd = openTerminal (master);
+  auto reader = readTerminal (master, drawn);
+  {
+    Tracker tracker (sampled);
+    auto begin = std::chrono::steady_clock::now ();
+    std::chrono::milliseconds passed {};
+    while ((passed = std::chrono::duration_cast <std::chrono::milliseconds> (std::chrono::steady_clock::now () - begin)).count () < 1000)
+    {
+      tracker.set (passed.count ());
+      std::this_thread::sleep_for (std::chrono::microseconds (100));
+    }
+
+    tracker.set (1000);
+  }
+
+  closeTerminal (sampled.fd, master, reader);
+
+  t.ok (frames (drawn) >= 5,                      "Tracker draws while the value changes");
+  t.ok (frames (drawn) <= 15,                     "Tracker draws no more than 10 frames a second");
+  t.ok (lastLine (drawn).find ("100%") != std::string::npos,
+                                                  "Tracker draws the final value");
+
+  // Workers never wait for the terminal, even when the render thread does.
+  // The terminal is filled before the bar is drawn, and only read once the
+  // workers are finished.
+  drawn.clear ();
+  Progress stuck;
+  stuck.maximum = 400000;
+  stuck.remove = false;
+  stuck.fps = 20;
+  stuck.fd = openTerminal (master);
+
+  fcntl (stuck.fd, F_SETFL, O_NONBLOCK);
+  std::string lines (4096, '\n');
+  while (write (stuck.fd, lines.data (), lines.size ()) > 0)
+    ;
+  fcntl (stuck.fd, F_SETFL, 0);
+
+  std::chrono::milliseconds took {};
+  {
+    Tracker tracker (stuck);
+    std::this_thread::sleep_for (std::chrono::milliseconds (200));
+
+    auto begin = std::chrono::steady_clock::now ();
+    workers.clear ();
+    for (int i = 0; i < 8; ++i)
+      workers.push_back (std::thread ([&tracker]
+      {
+        for (int j = 0; j < 50000; ++j)
+          tracker.advance (1);
+      }));
+
+    for (auto& worker : workers)
+      worker.join ();
+
+    took = std::chrono::duration_cast <std::chrono::milliseconds> (std::chrono::steady_clock::now () - begin);
+    reader = readTerminal (master, drawn);
+  }
+
+  closeTerminal (stuck.fd, master, reader);
+
+  t.ok (took.count () < 1000,                     "Tracker workers finish while the terminal is full");
+  t.ok (lastLine (drawn).find ("100%") != std::string::npos,
+                                                  "Tracker draws the final value once the terminal drains");
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,108 @@
+#!/usr/bin/env python2.7
+# -*- coding: utf-8 -*-
+###############################################################################
+#
+# Copyright 2006 - 2017, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# http://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import sys
+import os
+import unittest
+import re
+import time
+import shutil
+import tempfile
+import threading
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Vramsteg, TestCase
+from basetest.utils import run_cmd_wait
+
+# Test methods available:
+#     self.assertEqual(a, b)
+#     self.assertNotEqual(a, b)
+#     self.assertTrue(x)
+#     self.assertFalse(x)
+#     self.assertIs(a, b)
+#     self.assertIsNot(substring, text)
+#     self.assertIsNone(x)
+#     self.assertIsNotNone(x)
+#     self.assertIn(substring, text)
+#     self.assertNotIn(substring, text
+#     self.assertRaises(e)
+#     self.assertRegexpMatches(text, pattern)
+#     self.assertNotRegexpMatches(text, pattern)
+#     self.tap("")
+
+class TestWatch(TestCase):
+    def setUp(self):
+        self.t = Vramsteg()
+        self.directory = tempfile.mkdtemp()
+        self.path = os.path.join(self.directory, "target")
+
+    def tearDown(self):
+        shutil.rmtree(self.directory)
+
+    def grow(self, chunks, size):
+        """Appends to the watched file in the background"""
+        def writer():
+            for i in range(chunks):
+                time.sleep(0.1)
+                with open(self.path, "a") as f:
+                    f.write("x" * size)
+        thread = threading.Thread(target=writer)
+        thread.start()
+        return thread
+
+    def test_watch_until_max(self):
+        """Verify that 'vramsteg --watch-file' exits once the file reaches --max"""
+        with open(self.path, "w") as f:
+            f.write("x" * 100)
+        thread = self.grow(3, 300)
+        code, out, err = self.t("--watch-file %s --max 1000" % self.path)
+        thread.join()
+        self.assertEqual(os.path.getsize(self.path), 1000)
+        self.assertNotIn("Error", err)
+
+    def test_watch_file_created_later(self):
+        """Verify that 'vramsteg --watch-file' follows a file that does not exist yet"""
+        thread = self.grow(2, 50)
+        code, out, err = self.t("--watch-file %s --max 100 --events - --interval 0" % self.path)
+        thread.join()
+        self.assertIn('"value":0,', out)
+        self.assertIn('"value":100,', out)
+        self.assertIn('"done":true}', out)
+
+    def test_watch_needs_max(self):
+        """Verify that 'vramsteg --watch-file' requires --max"""
+        code, out, err = self.t("--watch-file %s --current 1" % self.path)
+        self.assertIn("To use the --watch-file feature, --max must be provided.", err)
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+    unittest.main(testRunner=TAPTestRunner())
+
+# vim: ai sts=4 et sw=4 ft=python